@@ -2,43 +2,28 @@
 
 #include <format>
 
-#include "Process.h"
-
 ArithmeticInstruction::ArithmeticInstruction(const std::string& resultName, const Operand& lhsVar,
                                              const Operand& rhsVar, const Operation& operation, const int pid)
     : Instruction(1, pid), operation(operation), resultName(resultName), lhsVar(lhsVar), rhsVar(rhsVar) {
-    this->opCode = "ARITH";
 }
-void ArithmeticInstruction::execute() {
-    const uint16_t lhsValue = resolveOperand(lhsVar);
-    const uint16_t rhsValue = resolveOperand(rhsVar);
-    const auto process = getProcess();
-
-    if (operation == ADD) {
-        const uint32_t sum = static_cast<uint32_t>(lhsValue) + static_cast<uint32_t>(rhsValue);
 
-        // Need to clamp the value
-        const uint16_t result = sum > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(sum);
-
-        process->setVariable(resultName, result);
-    } else {
-        // Need to clamp the value
-        const uint16_t result = lhsValue < rhsValue ? 0 : lhsValue - rhsValue;
-        process->setVariable(resultName, result);
-    }
-}
+Bytecode ArithmeticInstruction::encode(Program& program) const {
+    Bytecode bytecode{operation == ADD ? Opcode::ADD : Opcode::SUB, A_IS_VAR};
+    // Reading an undeclared operand declares it, assigning to the result doesn't
+    bytecode.a = program.variable(resultName, false);
 
-uint16_t ArithmeticInstruction::resolveOperand(const Operand& op) const {
-    const auto process = getProcess();
+    // Literals are stored as is, variables by index
+    const auto encodeOperand = [&](const Operand& operand, const OperandFlags flag) -> uint16_t {
+        if (const auto* literal = std::get_if<uint16_t>(&operand))
+            return *literal;
 
-    if (std::holds_alternative<std::string>(op)) {
-        const auto& varName = std::get<std::string>(op);
-        const auto value = process->getVariable(varName);
+        bytecode.flags |= flag;
+        return program.variable(std::get<std::string>(operand), true);
+    };
+    bytecode.b = encodeOperand(lhsVar, B_IS_VAR);
+    bytecode.c = encodeOperand(rhsVar, C_IS_VAR);
 
-        return value;
-    } else {
-        return std::get<uint16_t>(op);
-    }
+    return bytecode;
 }
 
 std::string ArithmeticInstruction::getOperandString(const Operand& operand) const {
@@ -11,14 +11,13 @@ public:
     ArithmeticInstruction(const std::string& resultName, const Operand& lhsVar, const Operand& rhsVar,
                           const Operation& operation, const int pid);
 
-    void execute() override;
-    uint16_t resolveOperand(const Operand& op) const;
+    Bytecode encode(Program& program) const override;
     std::string getOperandString(const Operand& operand) const;
     std::string serialize() const override;
 
 private:
-    Operation operation;
-    std::string resultName;
-    Operand lhsVar;
-    Operand rhsVar;
+    const Operation operation;
+    const std::string resultName;
+    const Operand lhsVar;
+    const Operand rhsVar;
 };
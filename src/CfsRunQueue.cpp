@@ -0,0 +1,40 @@
+#include "CfsRunQueue.h"
+
+#include <utility>
+
+#include "Process.h"
+
+void CfsRunQueue::enqueue(const std::shared_ptr<Process>& process) {
+    tree.insert({process->getVruntime(), nextSequence++, process});
+}
+
+std::shared_ptr<Process> CfsRunQueue::dequeue() {
+    auto node = tree.extract(tree.begin());
+    return std::move(node.value().process);
+}
+
+// An idle thief runs whatever it takes right away, so it should also get the
+// process that is owed the most
+std::shared_ptr<Process> CfsRunQueue::dequeueForSteal() {
+    return dequeue();
+}
+
+void CfsRunQueue::requeueAll(const std::function<void(Process&)>& update) {
+    auto old = std::exchange(tree, {});
+
+    for (const auto& entry : old) {
+        update(*entry.process);
+        enqueue(entry.process);
+    }
+}
+
+std::optional<uint64_t> CfsRunQueue::topKey() const {
+    if (tree.empty())
+        return std::nullopt;
+
+    return tree.begin()->vruntime;
+}
+
+size_t CfsRunQueue::queued() const {
+    return tree.size();
+}
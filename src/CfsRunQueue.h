@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+
+#include "RunQueue.h"
+
+/// @class CfsRunQueue
+/// @brief Run queue for the completely fair scheduler.
+///
+/// Keeps the runnable processes in a red-black tree (std::set) ordered by
+/// virtual runtime, so the one that has had the least CPU time relative to its
+/// weight is always the leftmost. Insert and pick-next are O(log n). The
+/// vruntime is captured when a process is queued and doesn't change until it
+/// runs again.
+class CfsRunQueue final : public RunQueue {
+protected:
+    void enqueue(const std::shared_ptr<Process>& process) override;
+    std::shared_ptr<Process> dequeue() override;
+    std::shared_ptr<Process> dequeueForSteal() override;
+    void requeueAll(const std::function<void(Process&)>& update) override;
+    [[nodiscard]] std::optional<uint64_t> topKey() const override;
+    [[nodiscard]] size_t queued() const override;
+
+private:
+    struct Entry {
+        uint64_t vruntime;
+        uint64_t sequence;  // Keeps equal vruntimes distinct and in arrival order
+        std::shared_ptr<Process> process;
+
+        bool operator<(const Entry& other) const {
+            return vruntime != other.vruntime ? vruntime < other.vruntime : sequence < other.sequence;
+        }
+    };
+
+    std::set<Entry> tree;
+    uint64_t nextSequence = 0;
+};
@@ -7,7 +7,9 @@
 #include <limits>
 #include <unordered_map>
 #include <cmath>
+#include <format>
 #include <print>
+#include <sstream>
 
 std::string stripQuotes(const std::string& input) {
     if (input.size() >= 2 && input.front() == '"' && input.back() == '"') {
@@ -119,8 +121,183 @@ bool Config::loadFromFile() {
                   scheduler = SchedulerType::FCFS;
               else if (sched == "rr")
                   scheduler = SchedulerType::RR;
+              else if (sched == "mlfq")
+                  scheduler = SchedulerType::MLFQ;
+              else if (sched == "srtf")
+                  scheduler = SchedulerType::SRTF;
+              else if (sched == "priority")
+                  scheduler = SchedulerType::PRIORITY;
+              else if (sched == "cfs")
+                  scheduler = SchedulerType::CFS;
+              else if (sched == "lottery")
+                  scheduler = SchedulerType::LOTTERY;
+              else if (sched == "stride")
+                  scheduler = SchedulerType::STRIDE;
               // Else, stick to default
          }},
+         {"tick-mode", [this](std::ifstream& f) {
+              std::string mode;
+              f >> mode;
+              mode = stripQuotes(mode);
+              std::ranges::transform(mode, mode.begin(), ::tolower);
+
+              if (mode == "free")
+                  tickMode = TickMode::FREE_RUN;
+              else if (mode == "rate")
+                  tickMode = TickMode::RATE_LIMITED;
+              // Else, stick to default
+         }},
+         {"tick-rate",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              tickRate = static_cast<uint32_t>(std::clamp(value, int64_t{1}, int64_t{1000000}));
+          }},
+         {"sync-epoch",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              syncEpoch = static_cast<uint32_t>(std::clamp(value, int64_t{1}, int64_t{1024}));
+          }},
+         {"host-threads",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              hostThreads = static_cast<uint32_t>(std::clamp(value, int64_t{0}, int64_t{128}));
+          }},
+         {"pin-host-threads", [this](std::ifstream& f) {
+              std::string value;
+              f >> value;
+              value = stripQuotes(value);
+              std::ranges::transform(value, value.begin(), ::tolower);
+              pinHostThreads = value == "true" || value == "1";
+         }},
+         {"mlfq-levels",
+          [this](std::ifstream& f) {
+              int value;
+              f >> value;
+              mlfqLevels = std::clamp(value, 1, 8);
+          }},
+         {"mlfq-quantums", [this](std::ifstream& f) {
+              // Comma separated, one per level starting from the highest
+              std::string list;
+              f >> list;
+              list = stripQuotes(list);
+
+              mlfqQuantums.clear();
+              std::stringstream stream(list);
+              for (std::string item; std::getline(stream, item, ',');) {
+                  try {
+                      mlfqQuantums.push_back(static_cast<uint32_t>(std::clamp(std::stoll(item), 1LL, 1000000LL)));
+                  } catch (const std::exception&) {
+                      std::println("Warning: Ignoring invalid mlfq-quantums entry '{}'.", item);
+                  }
+              }
+         }},
+         {"mlfq-boost",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              mlfqBoostInterval = static_cast<uint32_t>(std::clamp(value, int64_t{1}, int64_t{1000000}));
+          }},
+         {"cfs-latency",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              cfsLatency = static_cast<uint32_t>(std::clamp(value, int64_t{1}, int64_t{1000000}));
+          }},
+         {"cfs-min-granularity",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              cfsMinGranularity = static_cast<uint32_t>(std::clamp(value, int64_t{1}, int64_t{1000000}));
+          }},
+         {"migration-cost",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              migrationCost = static_cast<uint32_t>(std::clamp(value, int64_t{0}, int64_t{1000}));
+          }},
+         {"numa-nodes",
+          [this](std::ifstream& f) {
+              int value;
+              f >> value;
+              numaNodes = std::clamp(value, 1, 128);
+          }},
+         {"remote-access-cost",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              remoteAccessCost = static_cast<uint32_t>(std::clamp(value, int64_t{0}, int64_t{1000}));
+          }},
+         {"smt-threads",
+          [this](std::ifstream& f) {
+              int value;
+              f >> value;
+              if (value != 1 && value != 2 && value != 4) {
+                  std::println("Warning: smt-threads must be 1, 2 or 4, using 1.");
+                  value = 1;
+              }
+              smtThreads = value;
+          }},
+         {"smt-yield",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              smtYield = static_cast<uint32_t>(std::clamp(value, int64_t{100}, int64_t{400}));
+          }},
+         {"trace-buffer",
+          [this](std::ifstream& f) {
+              int64_t value;
+              f >> value;
+              traceBuffer = static_cast<uint32_t>(std::clamp(value, int64_t{64}, int64_t{1} << 20));
+          }},
+         {"ticket-groups", [this](std::ifstream& f) {
+              // Comma separated "name:tickets", e.g. "web:300,batch:100"
+              std::string list;
+              f >> list;
+              list = stripQuotes(list);
+
+              ticketGroups.clear();
+              std::stringstream stream(list);
+              for (std::string item; std::getline(stream, item, ',');) {
+                  try {
+                      const auto colon = item.find(':');
+                      if (colon == 0 || colon == std::string::npos)
+                          throw std::invalid_argument(item);
+                      const int64_t tickets = std::stoll(item.substr(colon + 1));
+
+                      std::string name = item.substr(0, colon);
+                      std::ranges::transform(name, name.begin(), ::tolower);
+                      ticketGroups.emplace_back(name, static_cast<uint64_t>(std::clamp(tickets, int64_t{1},
+                                                                                        int64_t{1000000})));
+                  } catch (const std::exception&) {
+                      std::println("Warning: Ignoring invalid ticket-groups entry '{}'.", item);
+                  }
+              }
+         }},
+         {"core-capacity", [this](std::ifstream& f) {
+              // Comma separated, one per core: "N" retires N instructions every
+              // tick, "N/M" retires N every M ticks, e.g. "2,2,1/2,1/2"
+              std::string list;
+              f >> list;
+              list = stripQuotes(list);
+
+              coreCapacities.clear();
+              std::stringstream stream(list);
+              for (std::string item; std::getline(stream, item, ',');) {
+                  try {
+                      const auto slash = item.find('/');
+                      const int64_t instructions = std::stoll(item.substr(0, slash));
+                      const int64_t period = slash == std::string::npos ? 1 : std::stoll(item.substr(slash + 1));
+
+                      coreCapacities.push_back({static_cast<uint32_t>(std::clamp(instructions, int64_t{1}, int64_t{64})),
+                                                static_cast<uint32_t>(std::clamp(period, int64_t{1}, int64_t{64}))});
+                  } catch (const std::exception&) {
+                      std::println("Warning: Ignoring invalid core-capacity entry '{}'.", item);
+                  }
+              }
+         }},
         {"max-overall-mem",
           [this](std::ifstream& f) {
               uint64_t value;
@@ -173,6 +350,29 @@ SchedulerType Config::getSchedulerType() const {
     return scheduler;
 }
 
+std::string Config::getSchedulerName() const {
+    switch (scheduler) {
+        case SchedulerType::FCFS:
+            return "FCFS";
+        case SchedulerType::RR:
+            return "RR";
+        case SchedulerType::MLFQ:
+            return "MLFQ";
+        case SchedulerType::SRTF:
+            return "SRTF";
+        case SchedulerType::PRIORITY:
+            return "Priority";
+        case SchedulerType::CFS:
+            return "CFS";
+        case SchedulerType::LOTTERY:
+            return "Lottery";
+        case SchedulerType::STRIDE:
+            return "Stride";
+    }
+
+    return "Unknown";
+}
+
 uint64_t Config::getQuantumCycles() const {
     return quantumCycles + 1;
 }
@@ -194,6 +394,90 @@ uint64_t Config::getDelaysPerExec() const {
 }
 
 
+TickMode Config::getTickMode() const {
+    return tickMode;
+}
+
+uint32_t Config::getTickRate() const {
+    return tickRate;
+}
+
+uint32_t Config::getSyncEpoch() const {
+    return syncEpoch;
+}
+
+uint32_t Config::getHostThreads() const {
+    return hostThreads;
+}
+
+bool Config::getPinHostThreads() const {
+    return pinHostThreads;
+}
+
+int Config::getMlfqLevels() const {
+    return mlfqLevels;
+}
+
+// Levels without an explicit quantum get twice the one above them
+uint64_t Config::getMlfqQuantum(const int level) const {
+    if (level < static_cast<int>(mlfqQuantums.size()))
+        return mlfqQuantums[level];
+
+    const uint64_t last = mlfqQuantums.empty() ? getQuantumCycles() : mlfqQuantums.back();
+    const int doublings = level - std::max(static_cast<int>(mlfqQuantums.size()) - 1, 0);
+
+    return last << doublings;
+}
+
+uint64_t Config::getMlfqBoostInterval() const {
+    return mlfqBoostInterval;
+}
+
+uint64_t Config::getCfsLatency() const {
+    return cfsLatency;
+}
+
+uint64_t Config::getCfsMinGranularity() const {
+    return cfsMinGranularity;
+}
+
+uint64_t Config::getMigrationCost() const {
+    return migrationCost;
+}
+
+// A node needs at least one core
+int Config::getNumaNodes() const {
+    return std::min(numaNodes, static_cast<int>(numCPUs));
+}
+
+CoreCapacity Config::getCoreCapacity(const int coreId) const {
+    if (coreCapacities.empty())
+        return {};
+
+    return coreCapacities[std::min(static_cast<size_t>(coreId), coreCapacities.size() - 1)];
+}
+
+uint64_t Config::getRemoteAccessCost() const {
+    return remoteAccessCost;
+}
+
+int Config::getSmtThreads() const {
+    return smtThreads;
+}
+
+// Can't get more out of a core than every thread running flat out
+uint32_t Config::getSmtYield() const {
+    return std::min(smtYield, static_cast<uint32_t>(100 * smtThreads));
+}
+
+const std::vector<std::pair<std::string, uint64_t>>& Config::getTicketGroups() const {
+    return ticketGroups;
+}
+
+uint32_t Config::getTraceBuffer() const {
+    return traceBuffer;
+}
+
 uint64_t Config::getMaxOverallMem() const {
     return maxOverallMem;
 }
@@ -213,13 +497,50 @@ uint64_t Config::getMemPerProc() const {
 void Config::print() const {
     std::cout << "=== Loaded Configuration ===\n";
     std::cout << "Number of CPUs       : " << getNumCPUs() << '\n';
-    std::cout << "Scheduler            : "
-              << (scheduler == SchedulerType::FCFS ? "FCFS" : "RR") << '\n';
+    std::cout << "Scheduler            : " << getSchedulerName() << '\n';
     std::cout << "Quantum Cycles       : " << getQuantumCycles() << '\n';
+    if (scheduler == SchedulerType::MLFQ) {
+        std::cout << "MLFQ Quantums        : ";
+        for (int level = 0; level < mlfqLevels; ++level) {
+            std::cout << (level == 0 ? "" : ", ") << getMlfqQuantum(level);
+        }
+        std::cout << " (boost every " << mlfqBoostInterval << " ticks)\n";
+    }
+    if (scheduler == SchedulerType::CFS) {
+        std::cout << "CFS Latency          : " << getCfsLatency() << " (min granularity " << getCfsMinGranularity()
+                  << ")\n";
+    }
+    if (!ticketGroups.empty()) {
+        std::cout << "Ticket Groups        : ";
+        for (size_t i = 0; i < ticketGroups.size(); ++i) {
+            std::cout << (i == 0 ? "" : ", ") << ticketGroups[i].first << ':' << ticketGroups[i].second;
+        }
+        std::cout << '\n';
+    }
     std::cout << "Batch Process Freq   : " << getBatchProcessFreq() << '\n';
     std::cout << "Min Instructions     : " << getMinInstructions() << '\n';
     std::cout << "Max Instructions     : " << getMaxInstructions() << '\n';
     std::cout << "Delays per Execution : " << getDelaysPerExec() << '\n';
+    std::cout << "Tick Mode            : "
+              << (tickMode == TickMode::FREE_RUN ? "Free-run" : std::format("{} Hz", tickRate)) << '\n';
+    std::cout << "Sync Epoch           : " << getSyncEpoch() << '\n';
+    std::cout << "Host Threads         : " << (hostThreads == 0 ? "auto" : std::to_string(hostThreads))
+              << (pinHostThreads ? " (pinned)" : "") << '\n';
+    std::cout << "Migration Cost       : " << getMigrationCost() << " ticks\n";
+    std::cout << "NUMA Nodes           : " << getNumaNodes() << " (remote access +" << getRemoteAccessCost()
+              << " ticks)\n";
+    if (smtThreads > 1) {
+        std::cout << "SMT Threads          : " << getSmtThreads() << " per core (" << getSmtYield()
+                  << "% throughput when all busy)\n";
+    }
+    if (!coreCapacities.empty()) {
+        std::cout << "Core Capacity        : ";
+        for (size_t i = 0; i < coreCapacities.size(); ++i) {
+            std::cout << (i == 0 ? "" : ", ") << coreCapacities[i].instructions << '/' << coreCapacities[i].period;
+        }
+        std::cout << " (instructions/ticks)\n";
+    }
+    std::cout << "Trace Buffer         : " << getTraceBuffer() << " events per core\n";
     std::cout << "Max Overall Mem      : " << getMaxOverallMem() << '\n';
     std::cout << "Mem per Frame        : " << getMemPerFrame() << '\n';
     std::cout << "Min Mem per Proc     : " << getMinMemPerProc() << '\n';
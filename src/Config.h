@@ -2,10 +2,29 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 enum class SchedulerType {
     FCFS,
     RR,
+    MLFQ,      // Multi-level feedback queue
+    SRTF,      // Shortest remaining time first, preemptive
+    PRIORITY,  // Static priority, preemptive
+    CFS,       // Completely fair, ordered by weighted virtual runtime
+    LOTTERY,   // Proportional share, a random ticket picks who runs next
+    STRIDE,    // Proportional share, deterministic, lowest pass runs next
+};
+
+// How fast a core retires instructions: this many every period ticks
+struct CoreCapacity {
+    uint32_t instructions = 1;
+    uint32_t period = 1;
+};
+
+enum class TickMode {
+    FREE_RUN,      // Start the next tick as soon as every core is done
+    RATE_LIMITED,  // Target a fixed number of ticks per second
 };
 
 class Config {
@@ -20,11 +39,30 @@ public:
     bool loadFromFile();
     [[nodiscard]] int getNumCPUs() const;
     [[nodiscard]] SchedulerType getSchedulerType() const;
+    [[nodiscard]] std::string getSchedulerName() const;
     [[nodiscard]] uint64_t getQuantumCycles() const;
     [[nodiscard]] uint64_t getBatchProcessFreq() const;
     [[nodiscard]] uint64_t getMinInstructions() const;
     [[nodiscard]] uint64_t getMaxInstructions() const;
     [[nodiscard]] uint64_t getDelaysPerExec() const;
+    [[nodiscard]] TickMode getTickMode() const;
+    [[nodiscard]] uint32_t getTickRate() const;
+    [[nodiscard]] uint32_t getSyncEpoch() const;
+    [[nodiscard]] uint32_t getHostThreads() const;
+    [[nodiscard]] bool getPinHostThreads() const;
+    [[nodiscard]] int getMlfqLevels() const;
+    [[nodiscard]] uint64_t getMlfqQuantum(int level) const;
+    [[nodiscard]] uint64_t getMlfqBoostInterval() const;
+    [[nodiscard]] uint64_t getCfsLatency() const;
+    [[nodiscard]] uint64_t getCfsMinGranularity() const;
+    [[nodiscard]] uint64_t getMigrationCost() const;
+    [[nodiscard]] int getNumaNodes() const;
+    [[nodiscard]] CoreCapacity getCoreCapacity(int coreId) const;
+    [[nodiscard]] uint64_t getRemoteAccessCost() const;
+    [[nodiscard]] int getSmtThreads() const;
+    [[nodiscard]] uint32_t getSmtYield() const;
+    [[nodiscard]] const std::vector<std::pair<std::string, uint64_t>>& getTicketGroups() const;
+    [[nodiscard]] uint32_t getTraceBuffer() const;
     void print() const;
     [[nodiscard]] uint64_t getMaxOverallMem() const;
     [[nodiscard]] uint64_t getMemPerFrame() const;
@@ -45,6 +83,24 @@ private:
     uint32_t minInstructions = 1000;
     uint32_t maxInstructions = 2000;
     uint32_t delaysPerExec = 0;
+    TickMode tickMode = TickMode::RATE_LIMITED;
+    uint32_t tickRate = 1000;  // Ticks per second, only used when rate limited
+    uint32_t syncEpoch = 1;    // Max ticks cores may run between barriers, 1 is strict lockstep
+    uint32_t hostThreads = 0;  // Host threads the cores are spread over, 0 to match the host
+    bool pinHostThreads = false;
+    int mlfqLevels = 3;
+    std::vector<uint32_t> mlfqQuantums;  // Per level, empty levels double the one above
+    uint32_t mlfqBoostInterval = 1000;   // Ticks between moving everything back to the top level
+    uint32_t cfsLatency = 24;            // Ticks in which every runnable process should get a turn
+    uint32_t cfsMinGranularity = 3;      // Shortest slice a process gets, however many are runnable
+    uint32_t migrationCost = 0;          // Ticks to warm up the cache after moving to another core
+    int numaNodes = 1;                   // Cores and frames are split evenly between the nodes
+    std::vector<CoreCapacity> coreCapacities;  // Per core, the last one repeats for the rest
+    uint32_t remoteAccessCost = 2;       // Extra ticks for touching a frame on another node
+    int smtThreads = 1;                  // Hardware threads per core
+    uint32_t smtYield = 125;             // Throughput of a core with every thread busy, in % of one thread
+    std::vector<std::pair<std::string, uint64_t>> ticketGroups;  // Name and tickets, shared by the members
+    uint32_t traceBuffer = 8192;         // Trace events each core can hold until the drainer catches up
 
     // New memory-related config values
     uint32_t maxOverallMem = 1024;
@@ -12,6 +12,7 @@
 #include "Process.h"
 #include "ProcessScheduler.h"
 #include "ProcessScreen.h"
+#include "Tracer.h"
 
 // Constants for memory validation
 constexpr int MIN_MEMORY_SIZE = 64;
@@ -121,7 +122,8 @@ bool ConsoleManager::validateInstructionsFitMemory(const std::vector<std::string
 
 /// Creates a process with custom instructions and memory size
 bool ConsoleManager::createProcessWithCustomInstructions(const std::string& processName, int memSize,
-                                                         const std::string& instrStr) {
+                                                         const std::string& instrStr,
+                                                         const ProcessOptions& options) {
     // Check if process name already exists
     if (processNameMap.contains(processName)) {
         std::println("Error: Process '{}' already exists.", processName);
@@ -177,9 +179,17 @@ bool ConsoleManager::createProcessWithCustomInstructions(const std::string& proc
         return false;
     }
 
+    if (options.realTime && !ProcessScheduler::getInstance().admitRealTime(*options.realTime)) {
+        processNameMap.erase(processName);
+        processIDList.pop_back();
+        std::println("Error: Not enough CPU capacity left to admit '{}' as a real-time process.", processName);
+        return false;
+    }
+
     // Set instructions with addToMemory=false since we already allocated the exact memory size
     // The user-specified memSize already accounts for instructions + symbol table + data
     newProcess->setInstructions(instructions, false);
+    applyOptions(*newProcess, options);
     ProcessScheduler::getInstance().scheduleProcess(newProcess);
 
     std::println("Process '{}' created successfully with {} instructions and {} bytes of memory.", processName,
@@ -190,7 +200,7 @@ bool ConsoleManager::createProcessWithCustomInstructions(const std::string& proc
 
 /// Creates and registers a process using its name for future switching.
 /// Returns true if creation was successful, false if not.
-bool ConsoleManager::createProcess(const std::string& processName, int memSize) {
+bool ConsoleManager::createProcess(const std::string& processName, int memSize, const ProcessOptions& options) {
     // Don't allow duplicate process names because we use that to access them
     if (processNameMap.contains(processName)) {
         std::println("Error: Process '{}' already exists.", processName);
@@ -202,6 +212,11 @@ bool ConsoleManager::createProcess(const std::string& processName, int memSize)
         return false;
     }
 
+    if (options.realTime && !ProcessScheduler::getInstance().admitRealTime(*options.realTime)) {
+        std::println("Error: Not enough CPU capacity left to admit '{}' as a real-time process.", processName);
+        return false;
+    }
+
     std::unique_lock lock(processListMutex);
     const int PID = processIDList.size();
 
@@ -211,11 +226,22 @@ bool ConsoleManager::createProcess(const std::string& processName, int memSize)
 
     // const auto instructions = InstructionFactory::createAlternatingPrintAdd(PID);
     // newProcess->setInstructions(instructions);
+    applyOptions(*newProcess, options);
     ProcessScheduler::getInstance().scheduleProcess(newProcess);
 
     return true;
 }
 
+/// Sets up the scheduling side of a new process before it is first scheduled.
+void ConsoleManager::applyOptions(Process& process, const ProcessOptions& options) {
+    process.setPriority(options.priority);
+    process.setTickets(options.tickets);
+    if (options.ticketGroup)
+        process.joinTicketGroup(options.ticketGroup);
+    if (options.realTime)
+        process.makeRealTime(*options.realTime, ProcessScheduler::getInstance().getTotalCPUTicks());
+}
+
 std::shared_ptr<Process> ConsoleManager::createDummyProcess(const std::string& processName) {
     // Don't allow duplicate process names because we use that to access them
     if (processNameMap.contains(processName)) {
@@ -235,10 +261,16 @@ std::shared_ptr<Process> ConsoleManager::createDummyProcess(const std::string& p
     processIDList.push_back(newProcess);
 
     const std::vector<std::shared_ptr<Instruction>> instructions =
-        InstructionFactory::generateInstructions(PID, processName, requiredMemory);
+        InstructionFactory::generateInstructions(PID, requiredMemory);
 
     newProcess->setInstructions(instructions, true);
 
+    // Only the priority scheduler is there to show priorities off. CFS weighs
+    // processes by priority too, and would otherwise give dummies arbitrary
+    // shares of the CPU.
+    if (Config::getInstance().getSchedulerType() == SchedulerType::PRIORITY)
+        newProcess->setPriority(InstructionFactory::generateRandomNum(0, LOWEST_PRIORITY));
+
     return newProcess;
 }
 
@@ -271,6 +303,7 @@ void ConsoleManager::getUserInput() const {
 
 /// Sets the exit flag to true, signaling the main loop to terminate.
 void ConsoleManager::exitProgram() {
+    Tracer::getInstance().stop();  // Flush whatever is still in the rings
     hasExited = true;
 }
 
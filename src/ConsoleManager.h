@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
@@ -8,6 +9,14 @@
 #include "Process.h"
 #include "Screen.h"
 
+/// @brief Scheduling options for a process created from the command line.
+struct ProcessOptions {
+    int priority = 0;
+    std::optional<RealTimeParams> realTime;
+    uint64_t tickets = DEFAULT_TICKETS;
+    std::shared_ptr<TicketGroup> ticketGroup;  // Takes the place of tickets when set
+};
+
 /// @class ConsoleManager
 /// @brief Manages console screen rendering and input handling using a singleton
 /// pattern.
@@ -42,7 +51,7 @@ public:
     /// @param memSize
     /// @return True if the creation was successful, false otherwise.
     std::shared_ptr<Process> createDummyProcess(const std::string& processName);
-    bool createProcess(const std::string& processName, int memSize);
+    bool createProcess(const std::string& processName, int memSize, const ProcessOptions& options = {});
 
     /// @brief Returns whether the program is marked for exit.
     /// @return True if the program should exit, false otherwise.
@@ -70,7 +79,8 @@ public:
     /// @return true if process creation was successful, false otherwise
     bool createProcessWithCustomInstructions(const std::string& processName,
                                             int memSize,
-                                            const std::string& instrStr);
+                                            const std::string& instrStr,
+                                            const ProcessOptions& options = {});
 
 private:
     /// @brief Flag to indicate if the program should exit.
@@ -106,4 +116,6 @@ private:
     std::vector<std::string> parseInstructions(const std::string& instrStr) const;
 
     bool validateInstructionsFitMemory(const std::vector<std::string>& instructions, int memSize) const;
+
+    static void applyOptions(Process& process, const ProcessOptions& options);
 };
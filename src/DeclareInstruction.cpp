@@ -1,15 +1,13 @@
 #include "DeclareInstruction.h"
 
-#include "ConsoleManager.h"
-#include "Process.h"
+#include <format>
+
 DeclareInstruction::DeclareInstruction(const std::string& name, const uint16_t value, const int pid)
     : Instruction(1, pid), name(name), value(value) {
-    this->opCode = "DECLARE";
 }
 
-void DeclareInstruction::execute() {
-    const auto proc = getProcess();
-    proc->declareVariable(name, value);
+Bytecode DeclareInstruction::encode(Program& program) const {
+    return {Opcode::DECLARE, A_IS_VAR, program.variable(name, true), value};
 }
 
 std::string DeclareInstruction::serialize() const {
@@ -4,10 +4,10 @@
 class DeclareInstruction final : public Instruction {
 public:
     DeclareInstruction(const std::string& name, uint16_t value, int pid);
-    void execute() override;
+    Bytecode encode(Program& program) const override;
     std::string serialize() const override;
 
 private:
-    std::string name;
-    uint16_t value;
+    const std::string name;
+    const uint16_t value;
 };
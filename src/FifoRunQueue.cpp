@@ -0,0 +1,32 @@
+#include "FifoRunQueue.h"
+
+#include "Process.h"
+
+void FifoRunQueue::enqueue(const std::shared_ptr<Process>& process) {
+    queue.push_back(process);
+}
+
+std::shared_ptr<Process> FifoRunQueue::dequeue() {
+    auto process = queue.front();
+    queue.pop_front();
+
+    return process;
+}
+
+std::shared_ptr<Process> FifoRunQueue::dequeueForSteal() {
+    auto process = queue.back();
+    queue.pop_back();
+
+    return process;
+}
+
+// Order doesn't depend on anything but arrival, so update in place
+void FifoRunQueue::requeueAll(const std::function<void(Process&)>& update) {
+    for (const auto& process : queue) {
+        update(*process);
+    }
+}
+
+size_t FifoRunQueue::queued() const {
+    return queue.size();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <deque>
+
+#include "RunQueue.h"
+
+/// @class FifoRunQueue
+/// @brief Plain first-come, first-served run queue used by FCFS and RR.
+///
+/// The owning core pops the oldest process while thieves take the newest, so
+/// the two ends rarely contend for the same entries.
+class FifoRunQueue final : public RunQueue {
+protected:
+    void enqueue(const std::shared_ptr<Process>& process) override;
+    std::shared_ptr<Process> dequeue() override;
+    std::shared_ptr<Process> dequeueForSteal() override;
+    void requeueAll(const std::function<void(Process&)>& update) override;
+    [[nodiscard]] size_t queued() const override;
+
+private:
+    std::deque<std::shared_ptr<Process>> queue;
+};
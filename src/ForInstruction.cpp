@@ -1,53 +1,41 @@
 #include "ForInstruction.h"
 
-#include <print>
-
-#include "Process.h"
+#include <format>
+#include <stdexcept>
 
 ForInstruction::ForInstruction(const int pid, const int totalLoops,
                                const std::vector<std::shared_ptr<Instruction>> &instructions)
-    : Instruction(0, pid), totalLoops(totalLoops), currentLoop(0), currentInstructIdx(0), instructions(instructions) {
-    this->opCode = "FOR";
+    : Instruction(0, pid), totalLoops(totalLoops), instructions(instructions), textSize(2) {
     int totalLineCount = 0;
     for (const auto &line : instructions) {
         totalLineCount += line->getLineCount();
+        textSize += line->getTextSize();
     }
 
     lineCount = totalLoops * totalLineCount;
 }
 
-void ForInstruction::execute() {
-    if (currentInstructIdx >= instructions.size() || currentLoop >= totalLoops) {
-        std::println("Tried executing for-loop beyond bounds.");
-        return;
-    }
-    auto process = getProcess();
+Bytecode ForInstruction::encode(Program &) const {
+    throw std::logic_error("FOR loops compile to more than one instruction.");
+}
 
-    const auto &currentInstruction = instructions[currentInstructIdx];
-    currentInstruction->execute();
+void ForInstruction::compile(Program &program) const {
+    if (totalLoops < 0 || totalLoops > UINT16_MAX)
+        throw std::runtime_error(std::format("FOR loop can't run {} times.", totalLoops));
 
-    if (currentInstruction->isComplete()) {
-        currentInstructIdx = (currentInstructIdx + 1) % instructions.size();
+    const int start = static_cast<int>(program.size());
 
-        // Check if it's 0, if it is that means we've looped back.
-        if (currentInstructIdx == 0) {
-            currentLoop++;
-        }
-        // If it's a for-loop, we have to restart its counters for the next
-        // iterations.
-        if (const auto forInst = std::dynamic_pointer_cast<ForInstruction>(currentInstruction)) {
-            forInst->restartCounters();
-        }
-    }
-}
+    Bytecode loop{Opcode::LOOP, 0, static_cast<uint16_t>(totalLoops)};
+    loop.setTarget(start + textSize - 1);
+    program.push(loop);
 
-bool ForInstruction::isComplete() const {
-    return currentLoop >= totalLoops;
-}
+    for (const auto &instr : instructions) {
+        instr->compile(program);
+    }
 
-void ForInstruction::restartCounters() {
-    currentLoop = 0;
-    currentInstructIdx = 0;
+    Bytecode endLoop{Opcode::END_LOOP};
+    endLoop.setTarget(start);
+    program.push(endLoop);
 }
 
 std::string ForInstruction::serialize() const {
@@ -62,19 +50,14 @@ std::string ForInstruction::serialize() const {
     return output;
 }
 
-std::vector<std::shared_ptr<Instruction>> ForInstruction::expand() const {
-    std::vector<std::shared_ptr<Instruction>> result;
+int ForInstruction::getTextSize() const noexcept {
+    return textSize;
+}
 
-    for (int loop = 0; loop < totalLoops; ++loop) {
-        for (const auto &instr : instructions) {
-            if (const auto nestedFor = std::dynamic_pointer_cast<ForInstruction>(instr)) {
-                auto expanded = nestedFor->expand();
-                result.insert(result.end(), expanded.begin(), expanded.end());
-            } else {
-                result.push_back(instr);
-            }
-        }
-    }
+int ForInstruction::getTotalLoops() const {
+    return totalLoops;
+}
 
-    return result;
+const std::vector<std::shared_ptr<Instruction>> &ForInstruction::getInstructions() const {
+    return instructions;
 }
@@ -6,19 +6,20 @@
 
 class ForInstruction final : public Instruction {
 public:
-    void execute() override;
-    bool isComplete() const override;
-    void restartCounters();
+    /// @brief Loops compile to more than one instruction, see compile().
+    Bytecode encode(Program& program) const override;
+    /// @brief Compiles to a LOOP, the body once, and an END_LOOP that jumps
+    /// back until the process has run every iteration.
+    void compile(Program& program) const override;
     std::string serialize() const override;
-    std::vector<std::shared_ptr<Instruction>> expand() const;
+    [[nodiscard]] int getTextSize() const noexcept override;
     ForInstruction(const int pid, int totalLoops, const std::vector<std::shared_ptr<Instruction>> &instructions);
 
-private:
-    int totalLoops;
-    int currentLoop;
-
-    int nestLevel = 1;
-    int currentInstructIdx;
+    int getTotalLoops() const;
+    const std::vector<std::shared_ptr<Instruction>> &getInstructions() const;
 
-    std::vector<std::shared_ptr<Instruction>> instructions;
+private:
+    const int totalLoops;
+    const std::vector<std::shared_ptr<Instruction>> instructions;
+    int textSize;
 };
@@ -0,0 +1,92 @@
+#include "HeapRunQueue.h"
+
+#include <utility>
+
+#include "Process.h"
+
+HeapRunQueue::HeapRunQueue(const KeyFunction key) : key(key) {
+}
+
+bool HeapRunQueue::before(const Entry& a, const Entry& b) {
+    return a.key != b.key ? a.key < b.key : a.sequence < b.sequence;
+}
+
+void HeapRunQueue::siftUp(size_t index) {
+    Entry entry = std::move(heap[index]);
+
+    while (index > 0) {
+        const size_t parent = (index - 1) / 2;
+        if (!before(entry, heap[parent]))
+            break;
+
+        heap[index] = std::move(heap[parent]);
+        index = parent;
+    }
+
+    heap[index] = std::move(entry);
+}
+
+void HeapRunQueue::siftDown(size_t index) {
+    Entry entry = std::move(heap[index]);
+
+    for (;;) {
+        size_t child = index * 2 + 1;
+        if (child >= heap.size())
+            break;
+        if (child + 1 < heap.size() && before(heap[child + 1], heap[child]))
+            ++child;
+        if (!before(heap[child], entry))
+            break;
+
+        heap[index] = std::move(heap[child]);
+        index = child;
+    }
+
+    heap[index] = std::move(entry);
+}
+
+void HeapRunQueue::enqueue(const std::shared_ptr<Process>& process) {
+    heap.push_back({key(*process), nextSequence++, process});
+    siftUp(heap.size() - 1);
+}
+
+std::shared_ptr<Process> HeapRunQueue::dequeue() {
+    auto process = std::move(heap.front().process);
+    if (heap.size() > 1) {
+        heap.front() = std::move(heap.back());
+        heap.pop_back();
+        siftDown(0);
+    } else {
+        heap.pop_back();
+    }
+
+    return process;
+}
+
+// A thief should still get the most urgent process
+std::shared_ptr<Process> HeapRunQueue::dequeueForSteal() {
+    return dequeue();
+}
+
+void HeapRunQueue::requeueAll(const std::function<void(Process&)>& update) {
+    for (auto& entry : heap) {
+        update(*entry.process);
+        entry.key = key(*entry.process);
+    }
+
+    // Floyd's heap construction, O(n)
+    for (size_t i = heap.size() / 2; i-- > 0;) {
+        siftDown(i);
+    }
+}
+
+std::optional<uint64_t> HeapRunQueue::topKey() const {
+    if (heap.empty())
+        return std::nullopt;
+
+    return heap.front().key;
+}
+
+size_t HeapRunQueue::queued() const {
+    return heap.size();
+}
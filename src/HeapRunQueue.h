@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "RunQueue.h"
+
+/// @class HeapRunQueue
+/// @brief Run queue ordered by a per-process key, smallest first.
+///
+/// Backs the preemptive policies (SRTF and priority), the EDF real-time class
+/// and stride scheduling. It is a binary min-heap, keyed when a process is
+/// queued. Keys only change while a process runs, and updateAll re-keys the
+/// whole queue at once. Equal keys are served in arrival order.
+class HeapRunQueue final : public RunQueue {
+public:
+    using KeyFunction = uint64_t (*)(const Process&);
+
+    explicit HeapRunQueue(KeyFunction key);
+
+protected:
+    void enqueue(const std::shared_ptr<Process>& process) override;
+    std::shared_ptr<Process> dequeue() override;
+    std::shared_ptr<Process> dequeueForSteal() override;
+    void requeueAll(const std::function<void(Process&)>& update) override;
+    [[nodiscard]] std::optional<uint64_t> topKey() const override;
+    [[nodiscard]] size_t queued() const override;
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t sequence;  // Arrival order, breaks ties between equal keys
+        std::shared_ptr<Process> process;
+    };
+
+    [[nodiscard]] static bool before(const Entry& a, const Entry& b);
+
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+
+    KeyFunction key;
+    std::vector<Entry> heap;
+    uint64_t nextSequence = 0;
+};
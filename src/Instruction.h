@@ -1,15 +1,20 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
-class Process;
+#include "Program.h"
 
+/// @class Instruction
+/// @brief An instruction as generated or parsed, before it's compiled.
+///
+/// Instructions only exist while a program is being built. Processes run the
+/// bytecode they encode to, see Program and Interpreter. They never change
+/// after they're constructed.
 class Instruction {
 protected:
     int lineCount;
-    int pid;
-    std::string opCode;
-    std::shared_ptr<Process> getProcess() const;
+    const int pid;
 
 public:
     explicit Instruction(int lines, int pid);
@@ -20,16 +25,20 @@ public:
     Instruction& operator=(const Instruction&) = delete;
 
     Instruction(Instruction&&) = default;
-    Instruction& operator=(Instruction&&) = default;
-
-    // Instructions will generally be one-liners, except for the for loops.
-    virtual bool isComplete() const {
-        return true;
-    }
+    Instruction& operator=(Instruction&&) = delete;
 
     virtual std::string serialize() const = 0;
 
-    virtual void execute() = 0;
+    /// @brief The bytecode for this instruction, with its strings added to the
+    /// program's string table.
+    virtual Bytecode encode(Program& program) const = 0;
+
+    /// @brief Appends the bytecode for this instruction to the program.
+    virtual void compile(Program& program) const;
 
+    /// @brief Lines executed when run, counting every iteration of a loop.
     [[nodiscard]] virtual int getLineCount() const noexcept;
+    /// @brief Instructions this compiles to, each taking up space in the text segment.
+    [[nodiscard]] virtual int getTextSize() const noexcept;
+    [[nodiscard]] int getPid() const noexcept;
 };
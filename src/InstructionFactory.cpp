@@ -22,7 +22,6 @@
 std::mt19937 InstructionFactory::rng(std::random_device{}());
 
 constexpr int MAX_NESTED_LEVELS = 3;
-constexpr int MAX_VARIABLES = 32;
 constexpr int INSTRUCTION_SIZE = 2;
 constexpr int SYMBOL_TABLE_SIZE = 64;
 
@@ -46,6 +45,13 @@ std::string getExistingVarName(const std::set<std::string>& declaredVars) {
     return allVars[randomIndex];
 }
 
+// The name of whichever process runs it goes in before the full stop, so the
+// message is the same in every process
+std::shared_ptr<Instruction> createGreeting(const int pid) {
+    static const std::string greeting = "Hello world from .";
+    return std::make_shared<PrintInstruction>(greeting, pid, "", static_cast<uint16_t>(greeting.size() - 1));
+}
+
 uint16_t getRandomUint16() {
     return static_cast<uint16_t>(InstructionFactory::generateRandomNum(0, UINT16_MAX));
 }
@@ -55,7 +61,6 @@ uint8_t getRandomSleepTime() {
 }
 
 std::vector<std::shared_ptr<Instruction>> InstructionFactory::generateInstructions(const int pid,
-                                                                                   const std::string& processName,
                                                                                    const int requiredMemory) {
     const int minLines = Config::getInstance().getMinInstructions();
     const int maxLines = Config::getInstance().getMaxInstructions();
@@ -65,41 +70,56 @@ std::vector<std::shared_ptr<Instruction>> InstructionFactory::generateInstructio
     int accumulatedLines = 0;
 
     std::set<std::string> declaredVars;
-    const int startMemory = randMaxLines * INSTRUCTION_SIZE + SYMBOL_TABLE_SIZE;
 
     // Leave a chance of error for the READ/WRITEs
     constexpr double errorChance = 0.01;
     const int errorMemory = requiredMemory * errorChance;
 
-    // requiredMemory - SYMBOL_TABLE_SIZE because startMemory already contains that
-    const int endMemory = startMemory + (requiredMemory - SYMBOL_TABLE_SIZE) + errorMemory;
+    // The text segment is only as big as the loops turn out to be once they're
+    // generated, so heap addresses start out relative to the end of the symbol
+    // table. requiredMemory - SYMBOL_TABLE_SIZE because that's part of it.
+    const int endMemory = (requiredMemory - SYMBOL_TABLE_SIZE) + errorMemory;
 
+    int textSize = 0;
     while (accumulatedLines < randMaxLines) {
         const int remainingLines = randMaxLines - accumulatedLines;
-        auto instr = createRandomInstruction(pid, processName, declaredVars, 0, remainingLines, startMemory, endMemory);
+        auto instr = createRandomInstruction(pid, declaredVars, 0, remainingLines, 0, endMemory);
         const int lines = instr->getLineCount();
 
         if (lines > remainingLines)
             continue;
 
-        if (lines > 1) {
-            auto forInstr = std::dynamic_pointer_cast<ForInstruction>(instr);
+        instructions.push_back(instr);
+        accumulatedLines += lines;
+        textSize += instr->getTextSize();
+    }
 
-            if (forInstr) {
-                auto expanded = forInstr->expand();
-                instructions.insert(instructions.end(), expanded.begin(), expanded.end());
-            } else {
-                // fallback, just in case it's not a for loop for some reason
-                instructions.push_back(instr);
-            }
-        } else {
-            instructions.push_back(instr);
+    const int heapStart = textSize * INSTRUCTION_SIZE + SYMBOL_TABLE_SIZE;
+    for (auto& instr : instructions) {
+        instr = relocate(instr, heapStart);
+    }
+
+    return instructions;
+}
+
+std::shared_ptr<Instruction> InstructionFactory::relocate(const std::shared_ptr<Instruction>& instr, const int offset) {
+    if (const auto write = std::dynamic_pointer_cast<WriteInstruction>(instr))
+        return write->relocated(offset);
+
+    if (const auto read = std::dynamic_pointer_cast<ReadInstruction>(instr))
+        return read->relocated(offset);
+
+    if (const auto forInstr = std::dynamic_pointer_cast<ForInstruction>(instr)) {
+        std::vector<std::shared_ptr<Instruction>> body;
+        body.reserve(forInstr->getInstructions().size());
+        for (const auto& line : forInstr->getInstructions()) {
+            body.push_back(relocate(line, offset));
         }
 
-        accumulatedLines += lines;
+        return std::make_shared<ForInstruction>(forInstr->getPid(), forInstr->getTotalLoops(), body);
     }
 
-    return instructions;
+    return instr;
 }
 
 int InstructionFactory::generateRandomNum(const int min, const int max) {
@@ -121,12 +141,10 @@ Operand getRandomOperand(const std::set<std::string>& declaredVars) {
     return static_cast<uint16_t>(InstructionFactory::generateRandomNum(0, UINT16_MAX));
 }
 
-std::shared_ptr<Instruction> InstructionFactory::createRandomInstruction(const int pid, const std::string& processName,
+std::shared_ptr<Instruction> InstructionFactory::createRandomInstruction(const int pid,
                                                                          std::set<std::string>& declaredVars,
                                                                          const int currentNestLevel, const int maxLines,
                                                                          const int startMemory, const int endMemory) {
-    const std::string msg = std::format("Hello world from {}.", processName);
-
     const bool isLoopable = currentNestLevel < MAX_NESTED_LEVELS && maxLines > 1;
     const bool hasHeapSpace = startMemory < endMemory;
 
@@ -142,7 +160,7 @@ std::shared_ptr<Instruction> InstructionFactory::createRandomInstruction(const i
             }
 
             if (!hasVariables)
-                return std::make_shared<PrintInstruction>(msg, pid);
+                return createGreeting(pid);
 
             std::string var = getExistingVarName(declaredVars);
             std::string message = std::format("The value of {} is: ", var);
@@ -188,7 +206,7 @@ std::shared_ptr<Instruction> InstructionFactory::createRandomInstruction(const i
         }
         case 5: {  // WRITE(address, value)
             if (!hasHeapSpace)
-                return std::make_shared<PrintInstruction>(msg, pid);
+                return createGreeting(pid);
 
             bool hasVar = generateRandomNum(0, 1) % 2 == 1;
 
@@ -204,14 +222,14 @@ std::shared_ptr<Instruction> InstructionFactory::createRandomInstruction(const i
         }
         case 6: {  // READ(var, address)
             if (!hasHeapSpace)
-                return std::make_shared<PrintInstruction>(msg, pid);
+                return createGreeting(pid);
 
             std::string result = getRandomVarName(declaredVars);
             int address = generateRandomNum(startMemory, endMemory - 2);
             return std::make_shared<ReadInstruction>(result, address, pid);
         }
         case 7: {
-            return createForLoop(pid, processName, maxLines, declaredVars, currentNestLevel + 1, startMemory,
+            return createForLoop(pid, maxLines, declaredVars, currentNestLevel + 1, startMemory,
                                  endMemory);
         }
         default:;
@@ -221,8 +239,7 @@ std::shared_ptr<Instruction> InstructionFactory::createRandomInstruction(const i
     return std::make_shared<PrintInstruction>("Fallback Instruction", pid);
 }
 
-std::shared_ptr<Instruction> InstructionFactory::createForLoop(const int pid, const std::string& processName,
-                                                               const int maxLines, std::set<std::string>& declaredVars,
+std::shared_ptr<Instruction> InstructionFactory::createForLoop(const int pid, const int maxLines, std::set<std::string>& declaredVars,
                                                                const int currentNestLevel, const int startMemory,
                                                                const int endMemory) {
     if (maxLines <= 1 || currentNestLevel > MAX_NESTED_LEVELS) {
@@ -250,8 +267,8 @@ std::shared_ptr<Instruction> InstructionFactory::createForLoop(const int pid, co
     while (accumulatedLines < maxGeneratedLines) {
         const int remainingLines = maxGeneratedLines - accumulatedLines;
 
-        const auto instr = createRandomInstruction(pid, processName, declaredVars, currentNestLevel + 1, remainingLines,
-                                                   startMemory, endMemory);
+        const auto instr =
+            createRandomInstruction(pid, declaredVars, currentNestLevel + 1, remainingLines, startMemory, endMemory);
 
         const int lineCount = instr->getLineCount();
 
@@ -296,24 +313,26 @@ std::shared_ptr<Instruction> InstructionFactory::deserializeInstruction(std::ist
     if (type == "PRT") {
         int pid;
         bool hasVar;
-        std::optional<std::string> varName = std::nullopt;
+        bool hasName;
+        std::string varName;
+        std::optional<uint16_t> nameAt = std::nullopt;
         std::string message;
 
         is >> pid >> hasVar;
 
-        if (hasVar) {
-            std::string var;
-            is >> var;
-            varName = var;
+        if (hasVar)
+            is >> varName;
+
+        is >> hasName;
+        if (hasName) {
+            uint16_t at;
+            is >> at;
+            nameAt = at;
         }
 
         is >> std::quoted(message);
 
-        if (hasVar) {
-            return std::make_shared<PrintInstruction>(message, pid, varName.value());
-        }
-
-        return std::make_shared<PrintInstruction>(message, pid);
+        return std::make_shared<PrintInstruction>(message, pid, varName, nameAt);
     }
     if (type == "DCL") {
         std::string var;
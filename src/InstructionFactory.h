@@ -11,8 +11,7 @@
 class InstructionFactory {
 public:
     static uint64_t calculateProcessMemoryRequirement(int numInstructions);
-    static std::vector<std::shared_ptr<Instruction>> generateInstructions(int pid, const std::string& processName,
-                                                                          int requiredMemory);
+    static std::vector<std::shared_ptr<Instruction>> generateInstructions(int pid, int requiredMemory);
     static std::mt19937 rng;
     static int generateRandomNum(int min, int max);
     static std::vector<std::shared_ptr<Instruction>> createAlternatingPrintAdd(int pid);
@@ -23,12 +22,14 @@ public:
     const std::vector<std::string>& instructionStrings, int processID);
 
 private:
-    static std::shared_ptr<Instruction> createRandomInstruction(int pid, const std::string& processName,
-                                                                std::set<std::string>& declaredVars,
+    static std::shared_ptr<Instruction> createRandomInstruction(int pid, std::set<std::string>& declaredVars,
                                                                 int currentNestLevel, int maxLines, int startMemory,
                                                                 int endMemory);
 
-    static std::shared_ptr<Instruction> createForLoop(int pid, const std::string& processName, int maxLines,
-                                                      std::set<std::string>& declaredVars, int currentNestLevel,
-                                                      int startMemory, int endMemory);
+    static std::shared_ptr<Instruction> createForLoop(int pid, int maxLines, std::set<std::string>& declaredVars,
+                                                      int currentNestLevel, int startMemory, int endMemory);
+
+    /// @brief Moves the heap addresses of the instruction, and of any in its
+    /// body, this many bytes further on.
+    static std::shared_ptr<Instruction> relocate(const std::shared_ptr<Instruction>& instr, int offset);
 };
@@ -0,0 +1,70 @@
+#include "Interpreter.h"
+
+#include <format>
+#include <string>
+
+#include "Process.h"
+
+// Both clamp instead of wrapping around
+static uint16_t add(const uint16_t lhs, const uint16_t rhs) {
+    const uint32_t sum = static_cast<uint32_t>(lhs) + static_cast<uint32_t>(rhs);
+    return sum > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(sum);
+}
+
+static uint16_t subtract(const uint16_t lhs, const uint16_t rhs) {
+    return lhs < rhs ? 0 : lhs - rhs;
+}
+
+int Interpreter::execute(const ExecutionContext& context, const Program& program, const Bytecode& instruction,
+                         const int index) {
+    Process& process = context.process;
+    const auto operand = [&](const OperandFlags flag, const uint16_t value) {
+        return instruction.isVar(flag) ? process.getVariable(program.getSlot(value)) : value;
+    };
+
+    switch (instruction.opcode) {
+        case Opcode::PRINT: {
+            std::string message = program.getString(instruction.a);
+            if ((instruction.flags & A_HAS_NAME) != 0)
+                message.insert(instruction.c, process.getName());
+            if (instruction.isVar(B_IS_VAR))
+                message += std::to_string(operand(B_IS_VAR, instruction.b));
+
+            process.log(std::format("({}) Core:{} \"{}\"", process.getTimestamp(), context.coreId, message));
+            break;
+        }
+        case Opcode::DECLARE:
+            process.declareVariable(program.getSlot(instruction.a), instruction.b);
+            break;
+        case Opcode::ADD:
+        case Opcode::SUB: {
+            // In order, reading an undeclared variable declares it
+            const uint16_t lhs = operand(B_IS_VAR, instruction.b);
+            const uint16_t rhs = operand(C_IS_VAR, instruction.c);
+            process.setVariable(program.getSlot(instruction.a),
+                                instruction.opcode == Opcode::ADD ? add(lhs, rhs) : subtract(lhs, rhs));
+            break;
+        }
+        case Opcode::SLEEP:
+            process.sleepUntil(context.tick + instruction.a);
+            break;
+        case Opcode::WRITE:
+            process.writeToHeap(instruction.getAddress(), operand(A_IS_VAR, instruction.a));
+            break;
+        case Opcode::READ:
+            process.declareVariable(program.getSlot(instruction.a), process.readFromHeap(instruction.getAddress()));
+            break;
+        case Opcode::LOOP:
+            if (instruction.a == 0)
+                return instruction.getTarget() + 1;
+
+            process.enterLoop(instruction.a);
+            break;
+        case Opcode::END_LOOP:
+            if (process.nextIteration())
+                return instruction.getTarget() + 1;
+            break;
+    }
+
+    return index + 1;
+}
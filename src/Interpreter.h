@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Program.h"
+
+#include <cstdint>
+
+class Process;
+
+/// @brief Where an instruction runs, handed down by the core executing it so
+/// nothing has to be looked up along the way.
+struct ExecutionContext {
+    Process& process;
+    int coreId;
+    uint64_t tick;
+};
+
+/// @class Interpreter
+/// @brief Executes bytecode on behalf of a process.
+///
+/// Every tick a process runs, it fetches one instruction from its text segment
+/// and hands it here, where a single switch on the opcode runs it.
+/// There are no virtual calls on the way, and only PRINT allocates, to build
+/// its log line.
+class Interpreter {
+public:
+    /// @param index Where the instruction is in the program.
+    /// @return Index of the instruction to run next.
+    static int execute(const ExecutionContext& context, const Program& program, const Bytecode& instruction,
+                       int index);
+};
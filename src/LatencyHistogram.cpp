@@ -0,0 +1,75 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+void LatencyHistogram::record(const uint64_t value) {
+    buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t seen = max.load(std::memory_order_relaxed);
+    while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return max.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::getMean() const {
+    const uint64_t recorded = getCount();
+    return recorded == 0 ? 0.0 : static_cast<double>(sum.load(std::memory_order_relaxed)) / recorded;
+}
+
+uint64_t LatencyHistogram::getPercentile(const double percentile) const {
+    const uint64_t recorded = getCount();
+    if (recorded == 0)
+        return 0;
+
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * recorded)));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        seen += buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return std::min(highestValueIn(bucket), getMax());
+    }
+
+    return getMax();
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> LatencyHistogram::getBuckets() const {
+    std::vector<std::pair<uint64_t, uint64_t>> result;
+    for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket) {
+        if (const uint64_t recorded = buckets[bucket].load(std::memory_order_relaxed))
+            result.emplace_back(highestValueIn(bucket), recorded);
+    }
+
+    return result;
+}
+
+// Values up to 2 * SUB_BUCKETS get a bucket each. Above that, the top
+// SUB_BUCKET_BITS bits after the leading one pick the bucket within the
+// value's power of two.
+size_t LatencyHistogram::bucketOf(const uint64_t value) {
+    if (value < 2 * SUB_BUCKETS)
+        return value;
+
+    const int magnitude = std::bit_width(value) - 1;
+    const int shift = magnitude - SUB_BUCKET_BITS;
+    return (magnitude - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + ((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::highestValueIn(const size_t bucket) {
+    if (bucket < 2 * SUB_BUCKETS)
+        return bucket;
+
+    const int shift = static_cast<int>(bucket / SUB_BUCKETS) - 1;
+    const uint64_t lowest = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lowest + (uint64_t{1} << shift) - 1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// @class LatencyHistogram
+/// @brief Records tick counts in log-linear buckets, HDR histogram style.
+///
+/// Every power of two is split into 16 buckets, so any recorded value is known
+/// to within about 6% no matter how large it is, in a fixed 8 KB. Values below
+/// 32 are exact. Recording is a couple of relaxed atomic adds, so the cores can
+/// record from any host thread while the console reads percentiles.
+class LatencyHistogram {
+public:
+    void record(uint64_t value);
+
+    [[nodiscard]] uint64_t getCount() const;
+    [[nodiscard]] uint64_t getMax() const;
+    [[nodiscard]] double getMean() const;
+
+    /// @brief Smallest recorded value that the given percentage of values are at
+    /// or below, rounded up to the end of its bucket. 0 if nothing was recorded.
+    [[nodiscard]] uint64_t getPercentile(double percentile) const;
+
+    /// @brief The non-empty buckets as the highest value each holds and its count.
+    [[nodiscard]] std::vector<std::pair<uint64_t, uint64_t>> getBuckets() const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr size_t NUM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    [[nodiscard]] static size_t bucketOf(uint64_t value);
+    [[nodiscard]] static uint64_t highestValueIn(size_t bucket);
+
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<uint64_t> count = 0;
+    std::atomic<uint64_t> sum = 0;
+    std::atomic<uint64_t> max = 0;
+};
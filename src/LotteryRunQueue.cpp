@@ -0,0 +1,104 @@
+#include "LotteryRunQueue.h"
+
+#include <bit>
+#include <utility>
+
+#include "Process.h"
+
+LotteryRunQueue::LotteryRunQueue(const uint64_t seed) : random(seed) {
+}
+
+void LotteryRunQueue::enqueue(const std::shared_ptr<Process>& process) {
+    if (freeSlots.empty())
+        grow();
+
+    const size_t slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    slots[slot] = {process->getTickets(), process};
+    addTickets(slot, slots[slot].tickets);
+    ++count;
+}
+
+std::shared_ptr<Process> LotteryRunQueue::dequeue() {
+    const uint64_t ticket = std::uniform_int_distribution<uint64_t>(0, totalTickets - 1)(random);
+    return takeSlot(findHolder(ticket));
+}
+
+// A thief draws like the owner would, so stealing doesn't skew the shares
+std::shared_ptr<Process> LotteryRunQueue::dequeueForSteal() {
+    return dequeue();
+}
+
+void LotteryRunQueue::requeueAll(const std::function<void(Process&)>& update) {
+    std::vector<std::shared_ptr<Process>> processes;
+    for (size_t slot = 0; slot < slots.size(); ++slot) {
+        if (slots[slot].process)
+            processes.push_back(takeSlot(slot));
+    }
+
+    for (const auto& process : processes) {
+        update(*process);
+        enqueue(process);
+    }
+}
+
+size_t LotteryRunQueue::queued() const {
+    return count;
+}
+
+// Doubles the slots and rebuilds the tree over them in O(n). The size stays a
+// power of two so findHolder can walk down the tree one bit at a time.
+void LotteryRunQueue::grow() {
+    const size_t oldSize = slots.size();
+    const size_t newSize = std::max<size_t>(16, oldSize * 2);
+    slots.resize(newSize);
+
+    tree.assign(newSize + 1, 0);
+    for (size_t i = 1; i <= newSize; ++i) {
+        tree[i] += slots[i - 1].tickets;
+        if (const size_t parent = i + (i & -i); parent <= newSize)
+            tree[parent] += tree[i];
+    }
+
+    for (size_t slot = newSize; slot > oldSize; --slot) {
+        freeSlots.push_back(slot - 1);
+    }
+}
+
+void LotteryRunQueue::addTickets(const size_t slot, const uint64_t tickets) {
+    for (size_t i = slot + 1; i < tree.size(); i += i & -i) {
+        tree[i] += tickets;
+    }
+    totalTickets += tickets;
+}
+
+void LotteryRunQueue::removeTickets(const size_t slot, const uint64_t tickets) {
+    for (size_t i = slot + 1; i < tree.size(); i += i & -i) {
+        tree[i] -= tickets;
+    }
+    totalTickets -= tickets;
+}
+
+// Slot whose tickets cover the given one, counting from the first slot
+size_t LotteryRunQueue::findHolder(uint64_t ticket) const {
+    size_t position = 0;
+    for (size_t step = std::bit_floor(slots.size()); step > 0; step >>= 1) {
+        if (position + step < tree.size() && tree[position + step] <= ticket) {
+            position += step;
+            ticket -= tree[position];
+        }
+    }
+
+    return position;
+}
+
+std::shared_ptr<Process> LotteryRunQueue::takeSlot(const size_t slot) {
+    removeTickets(slot, slots[slot].tickets);
+    auto process = std::exchange(slots[slot], {}).process;
+
+    freeSlots.push_back(slot);
+    --count;
+
+    return process;
+}
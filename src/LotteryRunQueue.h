@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "RunQueue.h"
+
+/// @class LotteryRunQueue
+/// @brief Run queue for lottery scheduling.
+///
+/// Every queued process holds a number of tickets, and the next one to run is
+/// whoever holds a ticket drawn at random, so over time each gets a share of
+/// the core in proportion to its tickets. Processes sit in slots with a Fenwick
+/// tree over their ticket counts, which finds the holder of a ticket and
+/// updates the totals in O(log n). Tickets are captured when a process is queued.
+class LotteryRunQueue final : public RunQueue {
+public:
+    explicit LotteryRunQueue(uint64_t seed);
+
+protected:
+    void enqueue(const std::shared_ptr<Process>& process) override;
+    std::shared_ptr<Process> dequeue() override;
+    std::shared_ptr<Process> dequeueForSteal() override;
+    void requeueAll(const std::function<void(Process&)>& update) override;
+    [[nodiscard]] size_t queued() const override;
+
+private:
+    struct Slot {
+        uint64_t tickets = 0;
+        std::shared_ptr<Process> process;
+    };
+
+    void grow();
+    void addTickets(size_t slot, uint64_t tickets);
+    void removeTickets(size_t slot, uint64_t tickets);
+    [[nodiscard]] size_t findHolder(uint64_t ticket) const;
+    std::shared_ptr<Process> takeSlot(size_t slot);
+
+    std::vector<Slot> slots;
+    std::vector<uint64_t> tree;      // Fenwick tree over the slots, 1-based
+    std::vector<size_t> freeSlots;   // Slots without a process
+    uint64_t totalTickets = 0;
+    size_t count = 0;
+    std::mt19937_64 random;
+};
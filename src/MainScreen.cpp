@@ -1,20 +1,172 @@
 #include "MainScreen.h"
 
 #include <algorithm>
+#include <array>
+#include <barrier>
+#include <charconv>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <print>
 #include <ranges>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "ConsoleManager.h"
 #include "PagingAllocator.h"
 #include "ProcessScheduler.h"
+#include "TickBarrier.h"
+#include "Tracer.h"
+
+/// @brief Pulls "<option> <value>" pairs off the end of a command, e.g. the
+/// "-p 3" in "screen -s name 256 -p 3".
+/// @return The value of each option found.
+static std::unordered_map<std::string, std::string> takeTrailingOptions(std::vector<std::string>& tokens,
+                                                                        const std::set<std::string>& options) {
+    std::unordered_map<std::string, std::string> values;
+
+    while (tokens.size() >= 2 && options.contains(tokens[tokens.size() - 2])) {
+        values.try_emplace(tokens[tokens.size() - 2], tokens.back());
+        tokens.resize(tokens.size() - 2);
+    }
+
+    return values;
+}
+
+/// @brief Parses an option value that has to be a whole number. Unlike stoull,
+/// a sign or anything after the digits makes it invalid.
+/// @return The number, or nothing if it was invalid.
+static std::optional<uint64_t> parseCount(const std::string& value) {
+    uint64_t result = 0;
+    const char* end = value.data() + value.size();
+    const auto [ptr, error] = std::from_chars(value.data(), end, result);
+    if (error != std::errc{} || ptr != end)
+        return std::nullopt;
+
+    return result;
+}
+
+/// @brief Parses the "-p" option of screen -s and screen -c.
+/// @return The priority, or nothing if it was invalid.
+static std::optional<int> parsePriority(const std::unordered_map<std::string, std::string>& options) {
+    const auto it = options.find("-p");
+    if (it == options.end())
+        return 0;
+
+    if (const auto priority = parseCount(it->second); priority && *priority <= LOWEST_PRIORITY)
+        return static_cast<int>(*priority);
+
+    std::println("Error: Invalid priority '{}'. Must be between 0 and {}.", it->second, LOWEST_PRIORITY);
+    return std::nullopt;
+}
+
+/// @brief Parses the "-b", "-d" and "-t" options of screen -s and screen -c,
+/// the budget, deadline and period of a real-time process in ticks.
+/// @return False if they were invalid.
+static bool parseRealTime(const std::unordered_map<std::string, std::string>& options, ProcessOptions& result) {
+    const auto budget = options.find("-b");
+    const auto deadline = options.find("-d");
+    const auto period = options.find("-t");
+    if (budget == options.end() && deadline == options.end() && period == options.end())
+        return true;
+
+    if (budget != options.end() && period != options.end()) {
+        const auto budgetTicks = parseCount(budget->second);
+        const auto periodTicks = parseCount(period->second);
+        const auto deadlineTicks = deadline != options.end() ? parseCount(deadline->second) : periodTicks;
+
+        if (budgetTicks && periodTicks && deadlineTicks && *budgetTicks != 0 && *deadlineTicks >= *budgetTicks &&
+            *periodTicks >= *budgetTicks) {
+            result.realTime = RealTimeParams{*budgetTicks, *deadlineTicks, *periodTicks};
+            return true;
+        }
+    }
+
+    std::println("Error: Real-time processes need -b <budget> -t <period> [-d <deadline>] in ticks, with a "
+                 "nonzero budget no longer than the deadline or the period.");
+    return false;
+}
+
+/// @brief Parses the "-n" and "-g" options of screen -s and screen -c, the
+/// lottery/stride tickets of the process or the ticket group it shares.
+/// @return False if they were invalid.
+static bool parseTickets(const std::unordered_map<std::string, std::string>& options, ProcessOptions& result) {
+    if (options.contains("-g") && options.contains("-n")) {
+        std::println("Error: -n and -g can't be combined. A process in a ticket group gets the group's share.");
+        return false;
+    }
+
+    if (const auto it = options.find("-g"); it != options.end()) {
+        std::string name = it->second;
+        std::ranges::transform(name, name.begin(), ::tolower);
+
+        result.ticketGroup = ProcessScheduler::getInstance().getTicketGroup(name);
+        if (!result.ticketGroup) {
+            std::println("Error: Unknown ticket group '{}'. Groups are set with ticket-groups in the config.", name);
+            return false;
+        }
+    }
+
+    if (const auto it = options.find("-n"); it != options.end()) {
+        result.tickets = parseCount(it->second).value_or(0);
+
+        if (result.tickets == 0 || result.tickets > 1000000) {
+            std::println("Error: Invalid ticket count '{}'. Must be between 1 and 1000000.", it->second);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Parses every scheduling option of screen -s and screen -c.
+/// @return Nothing if any of them were invalid.
+static std::optional<ProcessOptions> parseProcessOptions(const std::unordered_map<std::string, std::string>& options) {
+    ProcessOptions result;
+
+    const auto priority = parsePriority(options);
+    if (!priority)
+        return std::nullopt;
+    result.priority = *priority;
+
+    if (!parseRealTime(options, result))
+        return std::nullopt;
+
+    if (!parseTickets(options, result))
+        return std::nullopt;
+
+    return result;
+}
+
+/// @brief Header and one row per histogram of the scheduling latency summary
+/// shown by screen -ls and report-util.
+static std::string formatLatencyHeader() {
+    return std::format("{:<18}{:>8}{:>8}{:>8}{:>8}{:>10}{:>8}", "Latency (ticks)", "count", "p50", "p90", "p99", "mean",
+                       "max");
+}
+
+static std::string formatLatencyRow(const std::string& name, const LatencyHistogram& histogram) {
+    return std::format("{:<18}{:>8}{:>8}{:>8}{:>8}{:>10.1f}{:>8}", name, histogram.getCount(),
+                       histogram.getPercentile(50), histogram.getPercentile(90), histogram.getPercentile(99),
+                       histogram.getMean(), histogram.getMax());
+}
+
+static std::vector<std::string> formatLatencySummary(const ProcessScheduler& scheduler) {
+    return {formatLatencyHeader(),
+            formatLatencyRow("Response", scheduler.getResponseTimes()),
+            formatLatencyRow("Ready queue wait", scheduler.getReadyWaits()),
+            formatLatencyRow("Turnaround", scheduler.getTurnaroundTimes()),
+            std::format("Context switches: {}, preemptions: {}", scheduler.getContextSwitches(),
+                        scheduler.getPreemptions())};
+}
 
 /// @brief Returns the singleton instance of MainScreen.
 /// @return A single shared instance of MainScreen.
@@ -66,9 +218,14 @@ __________                         .__       ________    _________
 /// Recognized commands:
 /// - "exit": Signals the ConsoleManager to exit the program loop.
 /// - "clear": Clears the console screen and prints the header.
-/// - "screen -s <name>": Placeholder for creating a new screen.
+/// - "screen -s <name> <mem> [-p <priority>] [-b <budget> -t <period> [-d <deadline>]]
+/// [-n <tickets> | -g <group>]": Creates a new process, real-time if given a
+/// budget and period, and switches to its screen.
 /// - "screen -r <name>": Placeholder for resuming a screen.
 /// - "screen -ls": Displays the processes
+/// - "trace-start [file]", "trace-stop", "trace-export [trace] [json]":
+/// Record scheduling events and convert them for chrome://tracing or Perfetto.
+/// - "benchmark-barrier": Times the host threads' barrier against std::barrier.
 /// - "scheduler-start", "scheduler-stop", "report-util", "initialize":
 /// Placeholders for other commands.
 ///
@@ -138,8 +295,22 @@ void MainScreen::handleUserInput() {
         ProcessScheduler& scheduler = ProcessScheduler::getInstance();
         std::println("Scheduler Status:");
         std::println("- CPU Cycles: {}", scheduler.getTotalCPUTicks());
+        std::println("- Tick Rate: {:.0f} ticks/s ({})", scheduler.getTickRate(),
+                     Config::getInstance().getTickMode() == TickMode::FREE_RUN
+                         ? "free-run"
+                         : std::format("target {} Hz", Config::getInstance().getTickRate()));
         std::println("- Dummy Generation: {}", scheduler.isGeneratingDummies() ? "Running" : "Stopped");
         std::println("- Available Cores: {}/{}", scheduler.getNumAvailableCores(), scheduler.getNumTotalCores());
+        if (scheduler.getNumBigCores() != 0) {
+            std::println("- Big/Little Cores: {}/{}", scheduler.getNumBigCores(),
+                         scheduler.getNumTotalCores() - scheduler.getNumBigCores());
+        }
+        std::println("- Real-Time: {} admitted, {:.2f} cores reserved, {} deadline misses", scheduler.getNumRealTime(),
+                     scheduler.getRealTimeLoad(), scheduler.getDeadlineMisses());
+        if (scheduler.getSmtThreads() > 1) {
+            std::println("- SMT: {} cores, {} threads each", scheduler.getNumPhysicalCores(),
+                         scheduler.getSmtThreads());
+        }
         scheduler.printQueues();
     } else if (cmd == "report-util") {
         generateUtilizationReport();
@@ -149,14 +320,27 @@ void MainScreen::handleUserInput() {
         generateProcessSMI();
     } else if (cmd == "vmstat") {
         generateVmStat();
+    } else if (cmd == "dump-stats") {
+        generateStatsDump();
+    } else if (cmd == "trace-start") {
+        startTrace(tokens.size() > 1 ? tokens[1] : "logs/trace.bin");
+    } else if (cmd == "trace-stop") {
+        stopTrace();
+    } else if (cmd == "benchmark-barrier") {
+        benchmarkBarrier();
+    } else if (cmd == "trace-export") {
+        exportTrace(tokens.size() > 1 ? tokens[1] : "logs/trace.bin", tokens.size() > 2 ? tokens[2] : "logs/trace.json");
     } else {
         std::println("Error: Unknown command {}", cmd);
     }
 }
 
-void MainScreen::handleScreenCommand(const std::vector<std::string>& tokens) {
+void MainScreen::handleScreenCommand(const std::vector<std::string>& command) {
     auto& console = ConsoleManager::getInstance();
 
+    std::vector<std::string> tokens = command;
+    const auto options = takeTrailingOptions(tokens, {"-p", "-b", "-d", "-t", "-n", "-g"});
+
     if (tokens.size() < 2) {
         std::println("Error: Not enough arguments for screen command.");
         return;
@@ -196,7 +380,11 @@ void MainScreen::handleScreenCommand(const std::vector<std::string>& tokens) {
                 return;
             }
 
-            if (console.createProcess(processName, memSize)) {
+            const auto processOptions = parseProcessOptions(options);
+            if (!processOptions)
+                return;
+
+            if (console.createProcess(processName, memSize, *processOptions)) {
                 console.switchConsole(processName);
             }
         } else {  // -r
@@ -209,7 +397,8 @@ void MainScreen::handleScreenCommand(const std::vector<std::string>& tokens) {
     if (flag == "-c") {
         if (tokens.size() < 5) {
             std::println("Error: screen -c requires <name> <mem_size> \"<instructions>\"");
-            std::println("Usage: screen -c <name> <mem_size> \"<instrs;separated;by;semicolons>\"");
+            std::println("Usage: screen -c <name> <mem_size> \"<instrs;separated;by;semicolons>\" [-p <priority>] "
+                         "[-b <budget> -t <period> [-d <deadline>]] [-n <tickets> | -g <group>]");
             return;
         }
 
@@ -245,8 +434,12 @@ void MainScreen::handleScreenCommand(const std::vector<std::string>& tokens) {
             return;
         }
 
+        const auto processOptions = parseProcessOptions(options);
+        if (!processOptions)
+            return;
+
         // Create the process with custom instructions
-        if (console.createProcessWithCustomInstructions(processName, memSize, instrStr)) {
+        if (console.createProcessWithCustomInstructions(processName, memSize, instrStr, *processOptions)) {
             console.switchConsole(processName);
         }
 
@@ -331,6 +524,10 @@ void MainScreen::printProcessReport() {
     }
 
     std::println("{:->30}", "");
+
+    for (const auto& line : formatLatencySummary(scheduler)) {
+        std::println("{}", line);
+    }
 }
 
 /// @brief Generates and saves a CPU utilization report to csopesy-log.txt
@@ -408,6 +605,24 @@ void MainScreen::generateUtilizationReport() {
             }
         }
 
+        outFile << "\n------------------------------\n\n";
+
+        for (const auto& line : formatLatencySummary(scheduler)) {
+            outFile << line << "\n";
+        }
+
+        // -1 for anything that hasn't happened yet
+        outFile << "\n" << std::format("{:<12}{:>10}{:>10}{:>12}{:>10}{:>10}", "Process", "response", "ready wait",
+                                        "turnaround", "switches", "preempts")
+                << "\n";
+        for (const auto& process : sorted) {
+            outFile << std::format("{:<12}{:>10}{:>10}{:>12}{:>10}{:>10}", process->getName(),
+                                   process->getResponseTime(), process->getReadyWait(),
+                                   process->getTurnaroundTime(), process->getContextSwitches(),
+                                   process->getPreemptions())
+                    << "\n";
+        }
+
         outFile << "\n------------------------------\n";
         outFile.close();
 
@@ -458,6 +673,30 @@ void MainScreen::generateProcessSMI() {
     std::println("{:.0f}%", memUtil);
     resetColor();
 
+    // With SMT, how busy each core and each of its threads has been since boot
+    if (const int smtThreads = scheduler.getSmtThreads(); smtThreads > 1) {
+        const auto coreTicks = scheduler.getCoreBusyTicks();
+        const auto threadTicks = scheduler.getThreadActiveTicks();
+        const double totalTicks = static_cast<double>(std::max<uint64_t>(1, scheduler.getTotalCPUTicks()));
+
+        setColor(36);
+        std::println("{}", std::string(header.length(), '='));
+        resetColor();
+
+        for (size_t core = 0; core < coreTicks.size(); ++core) {
+            setColor(36);
+            std::print("Core {:<3}: ", core);
+            setColor(33);
+            std::print("{:>3.0f}%", coreTicks[core] / totalTicks * 100.0);
+            resetColor();
+
+            for (int thread = 0; thread < smtThreads; ++thread) {
+                std::print("  T{} {:>3.0f}%", thread, threadTicks[core * smtThreads + thread] / totalTicks * 100.0);
+            }
+            std::println("");
+        }
+    }
+
     setColor(36);
     std::println("{}", std::string(header.length(), '='));
     resetColor();
@@ -525,6 +764,185 @@ void MainScreen::generateProcessSMI() {
     resetColor();
 }
 
+static std::string escapeJson(const std::string& text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+static std::string histogramToJson(const LatencyHistogram& histogram) {
+    std::string buckets;
+    for (const auto& [highest, count] : histogram.getBuckets()) {
+        buckets += std::format("{}[{}, {}]", buckets.empty() ? "" : ", ", highest, count);
+    }
+
+    return std::format(R"({{"count": {}, "mean": {:.3f}, "p50": {}, "p90": {}, "p99": {}, "p999": {}, "max": {}, )"
+                       R"("buckets": [{}]}})",
+                       histogram.getCount(), histogram.getMean(), histogram.getPercentile(50),
+                       histogram.getPercentile(90), histogram.getPercentile(99), histogram.getPercentile(99.9),
+                       histogram.getMax(), buckets);
+}
+
+/// @brief Writes the scheduling latency histograms and per-process counters to
+/// logs/scheduler-stats.json, for comparing schedulers with scripts. Buckets
+/// are listed as [highest value, count], and times that haven't happened yet
+/// as -1.
+void MainScreen::generateStatsDump() {
+    const ProcessScheduler& scheduler = ProcessScheduler::getInstance();
+
+    auto processes = ConsoleManager::getInstance().getProcessIdList();
+    std::erase(processes, nullptr);
+
+    std::filesystem::create_directories("logs");
+    std::ofstream outFile("logs/scheduler-stats.json");
+    if (!outFile.is_open()) {
+        std::println("Error: Could not create logs/scheduler-stats.json file.");
+        return;
+    }
+
+    constexpr std::array statusNames = {"ready", "running", "waiting", "done"};
+
+    outFile << "{\n";
+    outFile << std::format(R"(  "scheduler": "{}",)", Config::getInstance().getSchedulerName()) << "\n";
+    outFile << std::format(R"(  "tick": {},)", scheduler.getTotalCPUTicks()) << "\n";
+    outFile << std::format(R"(  "contextSwitches": {},)", scheduler.getContextSwitches()) << "\n";
+    outFile << std::format(R"(  "preemptions": {},)", scheduler.getPreemptions()) << "\n";
+    outFile << std::format(R"(  "responseTime": {},)", histogramToJson(scheduler.getResponseTimes())) << "\n";
+    outFile << std::format(R"(  "readyWait": {},)", histogramToJson(scheduler.getReadyWaits())) << "\n";
+    outFile << std::format(R"(  "turnaroundTime": {},)", histogramToJson(scheduler.getTurnaroundTimes())) << "\n";
+    outFile << "  \"processes\": [\n";
+    for (size_t i = 0; i < processes.size(); ++i) {
+        const auto& process = processes[i];
+        outFile << std::format(R"(    {{"pid": {}, "name": "{}", "status": "{}", "responseTime": {}, )"
+                               R"("readyWait": {}, "turnaroundTime": {}, "contextSwitches": {}, "preemptions": {}}})",
+                               process->getID(), escapeJson(process->getName()), statusNames[process->getStatus()],
+                               process->getResponseTime(), process->getReadyWait(), process->getTurnaroundTime(),
+                               process->getContextSwitches(), process->getPreemptions())
+                << (i + 1 < processes.size() ? "," : "") << "\n";
+    }
+    outFile << "  ]\n}\n";
+
+    std::println("Scheduler statistics written to logs/scheduler-stats.json");
+}
+
+void MainScreen::startTrace(const std::string& path) {
+    Tracer& tracer = Tracer::getInstance();
+    if (tracer.isEnabled()) {
+        std::println("Tracing is already running. Use 'trace-stop' to stop it first.");
+        return;
+    }
+
+    const auto directory = std::filesystem::path(path).parent_path();
+    if (!directory.empty())
+        std::filesystem::create_directories(directory);
+
+    if (!tracer.start(path)) {
+        std::println("Error: Could not create {} file.", path);
+        return;
+    }
+
+    std::println("Tracing scheduling events to {}", path);
+}
+
+void MainScreen::stopTrace() {
+    Tracer& tracer = Tracer::getInstance();
+    if (!tracer.isEnabled()) {
+        std::println("Tracing is not currently running.");
+        return;
+    }
+
+    tracer.stop();
+    std::println("Tracing stopped, {} events dropped", tracer.getDropped());
+}
+
+/// @brief Converts a binary trace to Chrome trace JSON, with processes named
+/// after the ones that still exist.
+void MainScreen::exportTrace(const std::string& tracePath, const std::string& jsonPath) {
+    const auto processName = [](const int pid) {
+        const auto process = ConsoleManager::getInstance().getProcessByPID(pid);
+        return process ? escapeJson(process->getName()) : std::format("pid {}", pid);
+    };
+
+    if (!Tracer::exportChromeTrace(tracePath, jsonPath, processName)) {
+        std::println("Error: Could not convert {} to {}.", tracePath, jsonPath);
+        return;
+    }
+
+    std::println("Chrome trace written to {}", jsonPath);
+}
+
+// Completion step for the barrier benchmark, times the phases after a warm-up
+struct PhaseClock {
+    static constexpr uint64_t WARMUP_PHASES = 100;
+
+    uint64_t* phases;
+    std::chrono::steady_clock::time_point* start;
+    std::chrono::steady_clock::time_point* end;
+
+    void operator()() const {
+        if (++*phases == WARMUP_PHASES)
+            *start = std::chrono::steady_clock::now();
+        *end = std::chrono::steady_clock::now();
+    }
+};
+
+/// @brief Runs the given number of threads through a barrier for that many
+/// phases.
+/// @return Average nanoseconds per phase, not counting the warm-up.
+template <typename Barrier>
+static double timeBarrier(const int participants, const uint64_t phases) {
+    uint64_t completed = 0;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    const PhaseClock clock{&completed, &start, &end};
+
+    std::unique_ptr<Barrier> barrier;
+    if constexpr (std::is_same_v<Barrier, std::barrier<std::function<void()>>>)
+        barrier = std::make_unique<Barrier>(participants, std::function<void()>(clock));
+    else
+        barrier = std::make_unique<Barrier>(participants, clock);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < participants; ++i) {
+        threads.emplace_back([&, i] {
+            for (uint64_t phase = 0; phase < phases; ++phase) {
+                if constexpr (std::is_same_v<Barrier, std::barrier<std::function<void()>>>)
+                    barrier->arrive_and_wait();
+                else
+                    barrier->arriveAndWait(i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto elapsed = std::chrono::duration<double, std::nano>(end - start).count();
+    return elapsed / static_cast<double>(phases - PhaseClock::WARMUP_PHASES);
+}
+
+/// @brief Compares the cost of one phase of the host threads' barrier with
+/// std::barrier and a type-erased completion, which it replaced.
+void MainScreen::benchmarkBarrier() {
+    std::println("{:>12} {:>16} {:>16} {:>8}", "Threads", "std::barrier", "TickBarrier", "Speedup");
+
+    for (const int participants : {4, 16, 64, 128}) {
+        // Fewer phases with more threads, so every row takes about as long
+        const uint64_t phases = std::max<uint64_t>(PhaseClock::WARMUP_PHASES * 10, 400'000 / participants);
+        const double standard = timeBarrier<std::barrier<std::function<void()>>>(participants, phases);
+        const double custom = timeBarrier<TickBarrier<PhaseClock>>(participants, phases);
+
+        std::println("{:>12} {:>13.0f} ns {:>13.0f} ns {:>7.2f}x", participants, standard, custom, standard / custom);
+    }
+
+    std::println("Host CPUs: {}", std::thread::hardware_concurrency());
+}
+
 void MainScreen::generateVmStat() {
     const ProcessScheduler& scheduler = ProcessScheduler::getInstance();
     const PagingAllocator& allocator = PagingAllocator::getInstance();
@@ -549,9 +967,25 @@ void MainScreen::generateVmStat() {
     std::println("{:>20} {}", activeTicks, "Active CPU ticks");
     std::println("{:>20} {}", idleTicks + activeTicks, "Overall Individual CPU ticks");
     std::println("{:>20} {}", totalTicks, "Total (Global) CPU ticks");
+    std::println("{:>20} {}", scheduler.getMigrations(), "Core migrations");
+    std::println("{:>20} {}", scheduler.getRemoteAccesses(), "Remote node memory accesses");
 
     std::println("{:>20} {}", numPagedIn, "Pages paged in");
     std::println("{:>20} {}", numPagedOut, "Pages paged out");
 
+    // Per core busy ticks followed by each of its threads' active ticks
+    if (const int smtThreads = scheduler.getSmtThreads(); smtThreads > 1) {
+        const auto coreTicks = scheduler.getCoreBusyTicks();
+        const auto threadTicks = scheduler.getThreadActiveTicks();
+
+        for (size_t core = 0; core < coreTicks.size(); ++core) {
+            std::print("{:>20} Core {} busy ticks (threads:", coreTicks[core], core);
+            for (int thread = 0; thread < smtThreads; ++thread) {
+                std::print(" {}", threadTicks[core * smtThreads + thread]);
+            }
+            std::println(")");
+        }
+    }
+
     std::println("==============================\n");
 }
\ No newline at end of file
@@ -29,7 +29,7 @@ public:
     /// @brief Handles user input, parses commands, and performs corresponding
     /// actions.
     void handleUserInput() override;
-    void handleScreenCommand(const std::vector<std::string>& tokens);
+    void handleScreenCommand(const std::vector<std::string>& command);
 
 private:
     /// @brief Private constructor to enforce singleton pattern.
@@ -49,4 +49,9 @@ private:
     void generateUtilizationReport();
     void generateProcessSMI();
     void generateVmStat();
+    void generateStatsDump();
+    void startTrace(const std::string& path);
+    void stopTrace();
+    void exportTrace(const std::string& tracePath, const std::string& jsonPath);
+    void benchmarkBarrier();
 };
\ No newline at end of file
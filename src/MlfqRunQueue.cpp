@@ -0,0 +1,67 @@
+#include "MlfqRunQueue.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "Process.h"
+
+MlfqRunQueue::MlfqRunQueue(const int numLevels) : levels(numLevels) {
+}
+
+void MlfqRunQueue::enqueue(const std::shared_ptr<Process>& process) {
+    const int level = std::clamp(process->getQueueLevel(), 0, static_cast<int>(levels.size()) - 1);
+
+    levels[level].push_back(process);
+    occupied |= 1u << level;
+    ++total;
+}
+
+int MlfqRunQueue::highestLevel() const {
+    return std::countr_zero(occupied);
+}
+
+std::shared_ptr<Process> MlfqRunQueue::dequeue() {
+    const int level = highestLevel();
+    auto& queue = levels[level];
+
+    auto process = queue.front();
+    queue.pop_front();
+    if (queue.empty())
+        occupied &= ~(1u << level);
+    --total;
+
+    return process;
+}
+
+// Thieves also want the most urgent work, just from the other end of the level
+std::shared_ptr<Process> MlfqRunQueue::dequeueForSteal() {
+    const int level = highestLevel();
+    auto& queue = levels[level];
+
+    auto process = queue.back();
+    queue.pop_back();
+    if (queue.empty())
+        occupied &= ~(1u << level);
+    --total;
+
+    return process;
+}
+
+// Requeues everything by its updated level, keeping the old relative order
+void MlfqRunQueue::requeueAll(const std::function<void(Process&)>& update) {
+    auto old = std::exchange(levels, decltype(levels)(levels.size()));
+    occupied = 0;
+    total = 0;
+
+    for (auto& queue : old) {
+        for (auto& process : queue) {
+            update(*process);
+            enqueue(process);
+        }
+    }
+}
+
+size_t MlfqRunQueue::queued() const {
+    return total;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "RunQueue.h"
+
+/// @class MlfqRunQueue
+/// @brief Multi-level feedback queue, one FIFO per priority level.
+///
+/// Processes are queued on the level stored in Process::getQueueLevel(), with
+/// level 0 being the highest priority. The scheduler takes care of demoting
+/// processes that use up their quantum and of the periodic boost, this only
+/// keeps the levels in order. A bitmask of non-empty levels makes finding the
+/// highest one a single instruction.
+class MlfqRunQueue final : public RunQueue {
+public:
+    explicit MlfqRunQueue(int numLevels);
+
+protected:
+    void enqueue(const std::shared_ptr<Process>& process) override;
+    std::shared_ptr<Process> dequeue() override;
+    std::shared_ptr<Process> dequeueForSteal() override;
+    void requeueAll(const std::function<void(Process&)>& update) override;
+    [[nodiscard]] size_t queued() const override;
+
+private:
+    [[nodiscard]] int highestLevel() const;
+
+    std::vector<std::deque<std::shared_ptr<Process>>> levels;
+    uint32_t occupied = 0;  // Bit i is set when level i is non-empty
+    size_t total = 0;
+};
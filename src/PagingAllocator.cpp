@@ -14,8 +14,9 @@
 
 #include "Config.h"
 #include "ConsoleManager.h"
-#include "InstructionFactory.h"
 #include "Process.h"
+#include "ProcessScheduler.h"
+#include "Tracer.h"
 
 static constexpr auto BACKING_STORE_FILE = "csopesy-backing-store.txt";
 
@@ -24,47 +25,48 @@ PagingAllocator& PagingAllocator::getInstance() {
     return *instance;
 }
 
-PageFaultResult PagingAllocator::handlePageFault(const int pid, const int pageNumber) {
+PageFaultResult PagingAllocator::handlePageFault(Process& process, const int pageNumber) {
     constexpr int maxAttempts = 10;
     int attempts = 0;
+    const int pid = process.getID();
 
-    const auto process = ConsoleManager::getInstance().getProcessByPID(pid);
-
-    if (!process) {
-        throw new std::runtime_error("Tried to handle page fault of non-existent process.");
-    }
+    // First touch placement, the page goes on the node of the core that needs it
+    const int core = process.getCurrentCore();
+    const int node = core != -1 ? ProcessScheduler::getInstance().getNodeOfCore(core) : 0;
+    Tracer::getInstance().record(TraceEventType::PAGE_FAULT, ProcessScheduler::getInstance().getCurrentTick(), pid,
+                                 pageNumber);
 
     // Load page data only once
     std::vector<std::optional<StoredData>> pageData;
     {
         std::lock_guard lock(pagingMutex);
-        const PageEntry entry = process->getPageEntry(pageNumber);
-        pageData = entry.inBackingStore ? swapIn(process, pageNumber) : process->getPageData(pageNumber);
+        const PageEntry entry = process.getPageEntry(pageNumber);
+        pageData = entry.inBackingStore ? swapIn(process, pageNumber) : process.getPageData(pageNumber);
     }
 
     while (true) {
         std::lock_guard lock(pagingMutex);
 
-        int frameIndex = allocateFrame(pid, pageNumber, pageData);
+        int frameIndex = allocateFrame(pid, pageNumber, pageData, node);
         if (frameIndex != -1) {
-            process->swapPageIn(pageNumber, frameIndex);
+            process.swapPageIn(pageNumber, frameIndex);
             ++numPagedIn;
             return SUCCESS;
         }
 
-        if (!evictVictimFrame()) {
+        if (!evictVictimFrame(node)) {
             ++attempts;
             std::this_thread::yield();
             continue;
         }
 
         // Retry allocation after eviction
-        frameIndex = allocateFrame(pid, pageNumber, pageData);
+        frameIndex = allocateFrame(pid, pageNumber, pageData, node);
         if (frameIndex == -1) {
             throw std::runtime_error("Failed to allocate frame after successful eviction");
         }
 
-        process->swapPageIn(pageNumber, frameIndex);
+        process.swapPageIn(pageNumber, frameIndex);
         ++numPagedIn;
         return SUCCESS;
     }
@@ -176,6 +178,10 @@ bool PagingAllocator::pinFrame(const int frameNumber, const int pid, const int p
     return true;
 }
 
+int PagingAllocator::getNodeOfFrame(const int frameNumber) const {
+    return static_cast<int>(static_cast<size_t>(frameNumber) * numNodes / totalFrames);
+}
+
 StoredData PagingAllocator::readFromFrame(const int frameNumber, const int offset) {
     if (frameNumber < 0 || frameNumber >= static_cast<int>(frameTable.size()))
         throw new std::runtime_error("Invalid frame number");
@@ -226,54 +232,71 @@ PagingAllocator::PagingAllocator() {
     this->totalFrames = overallMem / frameSize;
     frameTable.resize(totalFrames);
 
+    numNodes = Config::getInstance().getNumaNodes();
+    freeFrameIndices.resize(numNodes);
+    oldFrameQueues.resize(numNodes);
     for (int i = 0; i < totalFrames; ++i) {
-        freeFrameIndices.push_back(i);
+        freeFrameIndices[getNodeOfFrame(i)].push_back(i);
     }
 
     // If the backing store exists, clear it.
     std::ofstream backingStore(BACKING_STORE_FILE, std::ios::trunc);
 }
 
+// Takes a free frame from the given node, or the next node over if it has none
 int PagingAllocator::allocateFrame(const int pid, const int pageNumber,
-                                   const std::vector<std::optional<StoredData>>& pageData) {
-    if (freeFrameIndices.empty()) {
+                                   const std::vector<std::optional<StoredData>>& pageData, const int node) {
+    std::deque<int>* freeFrames = nullptr;
+    for (int i = 0; i < numNodes && !freeFrames; ++i) {
+        auto& candidate = freeFrameIndices[(node + i) % numNodes];
+        if (!candidate.empty())
+            freeFrames = &candidate;
+    }
+
+    if (!freeFrames) {
         return -1;  // Signal: no frame available
     }
 
-    const int frameIndex = freeFrameIndices.front();
-    freeFrameIndices.pop_front();
+    const int frameIndex = freeFrames->front();
+    freeFrames->pop_front();
 
     frameTable[frameIndex] = {pid, pageNumber, pageData, true};
-    oldFramesQueue.push_back(frameIndex);
+    oldFrameQueues[getNodeOfFrame(frameIndex)].push_back(frameIndex);
 
     ++allocatedFrames;
 
     return frameIndex;
 }
 
-bool PagingAllocator::evictVictimFrame() {
-    const int victimFrame = getVictimFrame();
+bool PagingAllocator::evictVictimFrame(const int node) {
+    const int victimFrame = getVictimFrame(node);
 
     // Means no frames were available to be replaced
     if (victimFrame == -1)
         return false;
 
+    const FrameInfo& victim = frameTable[victimFrame];
+    Tracer::getInstance().record(TraceEventType::EVICT, ProcessScheduler::getInstance().getCurrentTick(), victim.pid,
+                                 victim.pageNumber);
     swapOut(victimFrame);
 
     return true;
 }
 
-int PagingAllocator::getVictimFrame() {
-    const size_t oldFrames = oldFramesQueue.size();
-    for (size_t i = 0; i < oldFrames; ++i) {
-        const int victimIndex = oldFramesQueue.front();
-        oldFramesQueue.pop_front();
+// Oldest unpinned frame on the given node, so that the page replacing it ends
+// up local, or on the next node over if it has none
+int PagingAllocator::getVictimFrame(const int node) {
+    for (int i = 0; i < numNodes; ++i) {
+        auto& oldFrames = oldFrameQueues[(node + i) % numNodes];
+        for (size_t j = 0, size = oldFrames.size(); j < size; ++j) {
+            const int victimIndex = oldFrames.front();
+            oldFrames.pop_front();
 
-        if (!frameTable[victimIndex].isPinned) {
-            return victimIndex;
-        }
+            if (!frameTable[victimIndex].isPinned)
+                return victimIndex;
 
-        oldFramesQueue.push_back(victimIndex);
+            oldFrames.push_back(victimIndex);
+        }
     }
 
     return -1;
@@ -281,10 +304,10 @@ int PagingAllocator::getVictimFrame() {
 
 void PagingAllocator::freeFrame(const int frameIndex) {
     frameTable[frameIndex] = FrameInfo{};
-    freeFrameIndices.push_back(frameIndex);
+    freeFrameIndices[getNodeOfFrame(frameIndex)].push_back(frameIndex);
 
-    // Remove the frame from the old frames queue
-    std::erase(oldFramesQueue, frameIndex);
+    // Remove the frame from the old frames queue of its node
+    std::erase(oldFrameQueues[getNodeOfFrame(frameIndex)], frameIndex);
 
     --allocatedFrames;
 }
@@ -317,6 +340,7 @@ void PagingAllocator::swapOut(const int frameIndex) {
     }
 
     backingFile << pid << " " << pageNumber << "\n";
+    const auto program = process->getProgram();
     const int memSize = static_cast<int>(data.size());
 
     int i = 0;
@@ -353,9 +377,9 @@ void PagingAllocator::swapOut(const int frameIndex) {
                 backingFile << " x" << count;
             }
             backingFile << "\n";
-        } else if (data[i].has_value() && std::holds_alternative<std::shared_ptr<Instruction>>(data[i].value())) {
-            const auto& instr = std::get<std::shared_ptr<Instruction>>(data[i].value());
-            backingFile << "I " << i << " " << instr->serialize() << "\n";
+        } else if (program && data[i].has_value() && std::holds_alternative<Bytecode>(data[i].value())) {
+            const auto& instr = std::get<Bytecode>(data[i].value());
+            backingFile << "I " << i << " " << program->disassemble(instr, pid) << "\n";
             ++i;
         } else {
             ++i;
@@ -365,8 +389,8 @@ void PagingAllocator::swapOut(const int frameIndex) {
     freeFrame(frameIndex);
     this->numPagedOut += 1;
 }
-std::vector<std::optional<StoredData>> PagingAllocator::swapIn(std::shared_ptr<Process> process, int pageNumber) const {
-    const auto pid = process->getID();
+std::vector<std::optional<StoredData>> PagingAllocator::swapIn(const Process& process, int pageNumber) const {
+    const auto pid = process.getID();
 
     if (pid < 0 || pageNumber < 0) {
         throw std::invalid_argument("Invalid pid/page number for swapIn.");
@@ -428,7 +452,7 @@ std::vector<std::optional<StoredData>> PagingAllocator::swapIn(std::shared_ptr<P
 
             std::string serializedInstr = line.substr(line.find_first_of(" \t", 2) + 1);
             std::istringstream instrStream(serializedInstr);
-            auto instr = InstructionFactory::deserializeInstruction(instrStream);
+            const auto instr = process.getProgram()->assemble(instrStream);
 
             if (offset >= 0 && offset < static_cast<int>(storedData.size())) {
                 storedData[offset] = instr;
@@ -8,10 +8,12 @@
 #include <variant>
 #include <vector>
 
-class Instruction;
+#include "Program.h"
+
 class Process;
 
-using StoredData = std::variant<uint16_t, std::shared_ptr<Instruction>>;
+// A byte of memory, or the first byte of an instruction in the text segment
+using StoredData = std::variant<uint16_t, Bytecode>;
 
 struct FrameInfo {
     int pid = -1;
@@ -31,8 +33,9 @@ public:
     PagingAllocator(PagingAllocator&&) = delete;
     PagingAllocator& operator=(PagingAllocator&&) = delete;
 
-    // Handles a page fault by allocating a physical frame to the given virtual address
-    PageFaultResult handlePageFault(int pid, int pageNumber);
+    // Handles a page fault by allocating a physical frame to the given virtual address.
+    // The faulting process passes itself in, so nothing has to look it up.
+    PageFaultResult handlePageFault(Process& process, int pageNumber);
 
     // Frees all memory (physical and virtual) associated with a process
     void deallocate(int pid);
@@ -47,26 +50,30 @@ public:
     std::optional<uint16_t> readUint16FromFrame(int frameNumber, int offset) const;
     bool pinFrame(int frameNumber, int pid, int pageNumber);
 
+    // Frames are split into contiguous blocks, one per NUMA node
+    int getNodeOfFrame(int frameNumber) const;
+
     StoredData readFromFrame(int frameNumber, int offset);
     void writeToFrame(int frameNumber, int offset, uint16_t data);
 
 private:
     PagingAllocator();
 
-    int allocateFrame(int pid, int pageNumber, const std::vector<std::optional<StoredData>>& pageData);
-    bool evictVictimFrame();
-    int getVictimFrame();
+    int allocateFrame(int pid, int pageNumber, const std::vector<std::optional<StoredData>>& pageData, int node);
+    bool evictVictimFrame(int node);
+    int getVictimFrame(int node);
     void freeFrame(int frameIndex);
 
     void swapOut(int frameIndex);
-    std::vector<std::optional<StoredData>> swapIn(std::shared_ptr<Process> process, int pageNumber) const;
+    std::vector<std::optional<StoredData>> swapIn(const Process& process, int pageNumber) const;
 
     size_t totalFrames;
     std::atomic<size_t> allocatedFrames = 0;
 
     std::vector<FrameInfo> frameTable;
-    std::deque<int> freeFrameIndices;
-    std::deque<int> oldFramesQueue;
+    std::vector<std::deque<int>> freeFrameIndices;  // One free list per NUMA node
+    int numNodes = 1;
+    std::vector<std::deque<int>> oldFrameQueues;  // Allocated frames, oldest first, one FIFO per NUMA node
 
     std::atomic<int> numPagedIn = 0;
     std::atomic<int> numPagedOut = 0;
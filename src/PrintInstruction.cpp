@@ -4,27 +4,33 @@
 #include <print>
 #include <string>
 
-#include "ConsoleManager.h"
 #include "Process.h"
 
-PrintInstruction::PrintInstruction(const std::string& msg, const int pid)
-    : Instruction(1, pid), message(msg), varName("") {
-    this->opCode = "PRT";
+PrintInstruction::PrintInstruction(const std::string& msg, const int pid) : PrintInstruction(msg, pid, "") {
 }
 
 PrintInstruction::PrintInstruction(const std::string& msg, const int pid, const std::string& varName)
-    : Instruction(1, pid), message(msg), varName(varName) {
+    : PrintInstruction(msg, pid, varName, std::nullopt) {
 }
 
-void PrintInstruction::execute() {
-    const auto process = getProcess();
-
-    std::string varValue = varName != "" ? std::to_string(process->getVariable(varName)) : "";
-
-    const std::string logMessage =
-        std::format("({}) Core:{} \"{}{}\"", process->getTimestamp(), process->getCurrentCore(), message, varValue);
+PrintInstruction::PrintInstruction(const std::string& msg, const int pid, const std::string& varName,
+                                   const std::optional<uint16_t> nameAt)
+    : Instruction(1, pid), message(msg), varName(varName), nameAt(nameAt) {
+}
 
-    process->log(logMessage);
+Bytecode PrintInstruction::encode(Program& program) const {
+    Bytecode bytecode{Opcode::PRINT};
+    bytecode.a = program.intern(message);
+    if (nameAt) {
+        bytecode.flags |= A_HAS_NAME;
+        bytecode.c = *nameAt;
+    }
+    if (varName != "") {
+        bytecode.flags |= B_IS_VAR;
+        bytecode.b = program.variable(varName, true);
+    }
+
+    return bytecode;
 }
 
 const std::string& PrintInstruction::getMessage() const noexcept {
@@ -39,6 +45,10 @@ std::string PrintInstruction::serialize() const {
     if (hasVar)
         oss << varName << ' ';
 
+    oss << nameAt.has_value() << ' ';
+    if (nameAt)
+        oss << *nameAt << ' ';
+
     oss << std::quoted(message);
 
     return oss.str();
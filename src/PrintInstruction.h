@@ -2,6 +2,7 @@
 
 #include <concepts>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -10,14 +11,19 @@
 
 class PrintInstruction final : public Instruction {
 private:
-    std::string message;
-    std::string varName;
+    const std::string message;
+    const std::string varName;
+    const std::optional<uint16_t> nameAt;
 
 public:
     PrintInstruction(const std::string& msg, const int pid);
     PrintInstruction(const std::string& msg, const int pid, const std::string& varName);
+    /// @param nameAt Where in the message the name of the process running it
+    /// goes, if anywhere.
+    PrintInstruction(const std::string& msg, const int pid, const std::string& varName,
+                     std::optional<uint16_t> nameAt);
 
-    void execute() override;
+    Bytecode encode(Program& program) const override;
 
     [[nodiscard]] const std::string& getMessage() const noexcept;
     std::string serialize() const override;
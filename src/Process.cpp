@@ -4,6 +4,8 @@
 
 #include "Process.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <ctime>
@@ -16,13 +18,19 @@
 #include <set>
 #include <shared_mutex>
 #include <sstream>
+#include <utility>
 
 #include "Config.h"
+#include "Interpreter.h"
 #include "PagingAllocator.h"
+#include "ProcessScheduler.h"
+
+// CFS weight per priority, the same ~1.25x steps as Linux uses for nice 0 to 9
+constexpr std::array<uint64_t, LOWEST_PRIORITY + 1> PRIORITY_WEIGHTS = {1024, 820, 655, 526, 423,
+                                                                        335,  272, 215, 172, 137};
 
 // If INSTRUCTION_SIZE is 0, we assume it doesn't count toward paging
 constexpr int INSTRUCTION_SIZE = 2;
-constexpr int MAX_VARIABLES = 32;
 constexpr int VARIABLE_SIZE = 2;
 
 // Common constructor with all parameters
@@ -36,7 +44,7 @@ Process::Process(const int id, const std::string& name, const uint64_t requiredM
       status(READY),
       currentCore(-1),
       wakeupTick(0),
-      variableAddresses({}) {
+      declaredSlots(0) {
     timestamp = generateTimestamp();
 }
 
@@ -101,49 +109,93 @@ void Process::log(const std::string& entry) {
     logs.push_back(entry);
 }
 
-void Process::safePageFault(const int page) const {
+void Process::safePageFault(const int page) {
     PagingAllocator& allocator = PagingAllocator::getInstance();
     if (!pageTable[page].isValid || !allocator.pinFrame(pageTable[page].frameNumber, processID, page)) {
-        allocator.handlePageFault(this->processID, page);
+        allocator.handlePageFault(*this, page);
+    }
+
+    // Every memory access goes through here first
+    countFrameAccess(pageTable[page].frameNumber);
+}
+
+void Process::countFrameAccess(const int frameNumber) {
+    const int core = currentCore;
+    if (core == -1 || Config::getInstance().getNumaNodes() == 1)
+        return;
+
+    if (PagingAllocator::getInstance().getNodeOfFrame(frameNumber) != ProcessScheduler::getInstance().getNodeOfCore(core)) {
+        ++remoteAccesses;
+        ++pendingRemoteAccesses;
     }
 }
 
 /**
  * @brief Increments the current line number, up to the total number of lines.
  */
-void Process::incrementLine() {
+void Process::incrementLine(const ExecutionContext& context) {
     std::lock_guard lock(instructionsMutex);
     if (currentLine < totalLines) {
-        const int instrAddress = (currentInstructionIndex * INSTRUCTION_SIZE);
-        const auto [page, offset] = splitAddress(instrAddress);
-        safePageFault(page);
+        const auto program = this->program.load();
+
+        // Loop instructions run on the way to the next line, in the same tick
+        for (;;) {
+            if (currentInstructionIndex >= static_cast<int>(program->size())) {
+                throw std::runtime_error(std::format("Process {} ran past the end of its program.", processName));
+            }
+
+            const int instrAddress = (currentInstructionIndex * INSTRUCTION_SIZE);
+            const auto [page, offset] = splitAddress(instrAddress);
+            safePageFault(page);
 
-        {
             // std::lock_guard pageLock(pageTableMutex);
             auto frameNumber = pageTable[page].frameNumber;
 
             const auto instr = PagingAllocator::getInstance().readFromFrame(frameNumber, offset);
 
-            if (!std::holds_alternative<std::shared_ptr<Instruction>>(instr)) {
+            if (!std::holds_alternative<Bytecode>(instr)) {
                 throw std::runtime_error(std::format("Frame {} Offset {} is not an instruction.", frameNumber, offset));
             }
 
-            const auto parsedInstr = std::get<std::shared_ptr<Instruction>>(instr);
-            parsedInstr->execute();
-
-            currentLine++;
-
-            if (parsedInstr->isComplete())
-                currentInstructionIndex++;
+            const auto& bytecode = std::get<Bytecode>(instr);
+            currentInstructionIndex = Interpreter::execute(context, *program, bytecode, currentInstructionIndex);
+            if (!bytecode.isControl())
+                break;
         }
+
+        currentLine++;
     }
 
     if (currentLine >= totalLines) {
         this->status = DONE;
-        instructions.clear();
+        program.store(nullptr);
+        loopIterations = {};
     }
 }
 
+// A sleeping process is simply not stepped again until it has been woken up
+// and dispatched
+void Process::step(const ExecutionContext& context) {
+    incrementLine(context);
+}
+
+void Process::enterLoop(const uint16_t iterations) {
+    loopIterations.push_back(iterations);
+}
+
+bool Process::nextIteration() {
+    if (--loopIterations.back() > 0)
+        return true;
+
+    loopIterations.pop_back();
+    return false;
+}
+
+void Process::sleepUntil(const uint64_t tick) {
+    wakeupTick = tick;
+    status = WAITING;
+}
+
 ProcessStatus Process::getStatus() const {
     return status.load();
 }
@@ -158,14 +210,93 @@ void Process::setCurrentCore(const int coreId) {
 int Process::getCurrentCore() const {
     return currentCore.load();
 }
+int Process::getLastCore() const {
+    return lastCore;
+}
+
+uint64_t Process::getMigrations() const {
+    return migrations;
+}
+
+bool Process::recordDispatch(const int coreId) {
+    const bool migrated = lastCore != -1 && lastCore != coreId;
+    if (migrated)
+        ++migrations;
+
+    lastCore = coreId;
+    return migrated;
+}
+
+void Process::recordBurst(const bool usedFullQuantum) {
+    cpuBoundScore = std::clamp(cpuBoundScore + (usedFullQuantum ? 1 : -1), 0, 3);
+}
+
+bool Process::isCpuBound() const {
+    return cpuBoundScore >= 2;
+}
+
+uint64_t Process::getRemoteAccesses() const {
+    return remoteAccesses;
+}
+
+uint64_t Process::takePendingRemoteAccesses() {
+    return std::exchange(pendingRemoteAccesses, 0);
+}
+
+void Process::recordArrival(const uint64_t tick) {
+    arrivalTick = tick;
+    readySince = tick;
+}
+bool Process::hasArrived() const {
+    return arrivalTick != NOT_YET;
+}
+void Process::recordReady(const uint64_t tick) {
+    readySince = tick;
+}
+uint64_t Process::recordRunning(const uint64_t tick) {
+    const uint64_t waited = tick - std::min(readySince, tick);
+    readyWait += waited;
+    ++contextSwitches;
+    if (firstRunTick == NOT_YET)
+        firstRunTick = tick;
+
+    return waited;
+}
+void Process::recordPreemption() {
+    ++preemptions;
+}
+uint64_t Process::recordDone(const uint64_t tick) {
+    doneTick = tick;
+    return tick - std::min<uint64_t>(arrivalTick, tick);
+}
+
+int64_t Process::getResponseTime() const {
+    const uint64_t firstRun = firstRunTick;
+    return firstRun == NOT_YET ? -1 : static_cast<int64_t>(firstRun - arrivalTick);
+}
+int64_t Process::getTurnaroundTime() const {
+    const uint64_t done = doneTick;
+    return done == NOT_YET ? -1 : static_cast<int64_t>(done - arrivalTick);
+}
+uint64_t Process::getReadyWait() const {
+    return readyWait;
+}
+uint64_t Process::getContextSwitches() const {
+    return contextSwitches;
+}
+uint64_t Process::getPreemptions() const {
+    return preemptions;
+}
+
 void Process::setInstructions(const std::vector<std::shared_ptr<Instruction>>& instructions, const bool addToMemory) {
     std::lock_guard lock(instructionsMutex);
 
     // Set instruction-related props
-    this->instructions = instructions;
+    const auto compiled = Program::compile(instructions);
+    this->program.store(compiled);
     this->totalLines = 0;
 
-    const int instructionBytes = instructions.size() * INSTRUCTION_SIZE;
+    const int instructionBytes = compiled->size() * INSTRUCTION_SIZE;
     for (const auto& instr : instructions) {
         this->totalLines += instr->getLineCount();
     }
@@ -186,16 +317,17 @@ void Process::setInstructions(const std::vector<std::shared_ptr<Instruction>>& i
     segmentBoundaries[HEAP] = requiredMemory;
 }
 
-bool Process::setVariable(const std::string& name, const uint16_t value) {
-    std::lock_guard lock(variableMutex);
+std::shared_ptr<const Program> Process::getProgram() const {
+    return program.load();
+}
 
+bool Process::setVariable(const uint8_t slot, const uint16_t value) {
     // Variable must already be declared
-    if (!variableAddresses.contains(name)) {
+    if (slot == NO_SLOT || !isDeclared(slot)) {
         return false;
     }
 
-    const auto address = variableAddresses[name];
-    const auto [page, offset] = splitAddress(address);
+    const auto [page, offset] = splitAddress(getVariableAddress(slot));
 
     safePageFault(page);
 
@@ -206,43 +338,31 @@ bool Process::setVariable(const std::string& name, const uint16_t value) {
     return true;
 }
 
-uint16_t Process::getVariable(const std::string& name) {
-    std::unique_lock lock(variableMutex);
-
-    // CASE 1: Variable has been declared already
-    if (variableAddresses.contains(name)) {
-        const auto [page, offset] = splitAddress(variableAddresses[name]);
-
-        safePageFault(page);
-
-        const auto frameNumber = pageTable[page].frameNumber;
-        const auto data = PagingAllocator::getInstance().readFromFrame(frameNumber, offset);
-
-        if (std::holds_alternative<uint16_t>(data))
-            return std::get<uint16_t>(data);
-
-        throw std::runtime_error(std::format("Variable '{}' at address 0x{:04X} is not a uint16_t", name,
-                                             static_cast<int>(variableAddresses[name])));
+uint16_t Process::getVariable(const uint8_t slot) {
+    // Symbol Table limit reached
+    if (slot == NO_SLOT) {
+        return 0;
     }
 
-    // CASE 2: Variable has not been declared yet
-    const auto symbolTableStart = segmentBoundaries[TEXT];
-
-    // CASE 2.1: Symbol Table limit reached
-    if (variableOrder.size() >= MAX_VARIABLES) {
+    // Reading a variable that hasn't been declared yet declares it as 0
+    if (!isDeclared(slot)) {
+        declareVariable(slot, 0);
         return 0;
     }
 
-    // CASE 2.2: Variable can be declared
-    if (symbolTableStart + variableOrder.size() * VARIABLE_SIZE > requiredMemory) {
-        throw std::runtime_error("Tried to declare new variable while reading but memory exceeded");
-    }
+    const auto address = getVariableAddress(slot);
+    const auto [page, offset] = splitAddress(address);
+
+    safePageFault(page);
 
-    lock.unlock();
-    declareVariable(name, 0);
+    const auto frameNumber = pageTable[page].frameNumber;
+    const auto data = PagingAllocator::getInstance().readFromFrame(frameNumber, offset);
 
-    // Return 0 since it's an uninitialized variable
-    return 0;
+    if (std::holds_alternative<uint16_t>(data))
+        return std::get<uint16_t>(data);
+
+    throw std::runtime_error(
+        std::format("Variable in slot {} at address 0x{:04X} is not a uint16_t", slot, static_cast<int>(address)));
 }
 
 bool Process::getIsFinished() const {
@@ -256,28 +376,129 @@ void Process::setWakeupTick(const uint64_t value) {
     this->wakeupTick = value;
 }
 
-bool Process::declareVariable(const std::string& name, uint16_t value) {
-    std::lock_guard lock(variableMutex);
+int Process::getQueueLevel() const {
+    return queueLevel;
+}
+void Process::setQueueLevel(const int level) {
+    queueLevel = level;
+}
 
-    // Don't allow double declarations
-    if (variableAddresses.contains(name)) {
-        return false;
-    }
+int Process::getPriority() const {
+    return priority;
+}
+void Process::setPriority(const int value) {
+    priority = value;
+}
+
+uint64_t Process::getWeight() const {
+    return PRIORITY_WEIGHTS[std::clamp(priority, 0, LOWEST_PRIORITY)];
+}
+
+uint64_t Process::getVruntime() const {
+    return vruntime;
+}
+void Process::setVruntime(const uint64_t value) {
+    vruntime = value;
+}
+uint64_t Process::getTickets() const {
+    if (ticketGroup)
+        return std::max<uint64_t>(1, ticketGroup->tickets / std::max<uint64_t>(1, ticketGroup->members));
+
+    return std::max<uint64_t>(1, tickets);
+}
+void Process::setTickets(const uint64_t value) {
+    tickets = value;
+}
+void Process::joinTicketGroup(const std::shared_ptr<TicketGroup>& group) {
+    leaveTicketGroup();
+    ticketGroup = group;
+    ++ticketGroup->members;
+}
+void Process::leaveTicketGroup() {
+    if (ticketGroup)
+        --std::exchange(ticketGroup, nullptr)->members;
+}
+const std::shared_ptr<TicketGroup>& Process::getTicketGroup() const {
+    return ticketGroup;
+}
+
+uint64_t Process::getPass() const {
+    return pass;
+}
+void Process::setPass(const uint64_t value) {
+    pass = value;
+}
+void Process::chargePass(const uint64_t ticks) {
+    pass += ticks * STRIDE_1 / getTickets();
+}
+
+void Process::makeRealTime(const RealTimeParams& params, const uint64_t releaseTick) {
+    realTime = params;
+    jobRelease = releaseTick;
+    jobDeadline = releaseTick + params.deadline;
+    jobBudgetLeft = params.budget;
+}
+bool Process::isRealTime() const {
+    return realTime.has_value();
+}
+const RealTimeParams& Process::getRealTimeParams() const {
+    return *realTime;
+}
+
+uint64_t Process::getJobDeadline() const {
+    return jobDeadline;
+}
+uint64_t Process::getJobRelease() const {
+    return jobRelease;
+}
+
+bool Process::chargeJobBudget() {
+    if (jobBudgetLeft > 0)
+        --jobBudgetLeft;
+
+    return jobBudgetLeft == 0;
+}
+
+// A job that overran starts the next one late rather than releasing a backlog
+// of jobs that are already past their deadlines
+bool Process::completeJob(const uint64_t tick) {
+    const bool missed = tick > jobDeadline;
+    if (missed)
+        ++deadlineMisses;
+
+    jobRelease = std::max(jobRelease + realTime->period, missed ? tick : 0);
+    jobDeadline = jobRelease + realTime->deadline;
+    jobBudgetLeft = realTime->budget;
+
+    return missed;
+}
+uint64_t Process::getDeadlineMisses() const {
+    return deadlineMisses;
+}
+
+void Process::chargeVruntime(const uint64_t ticks) {
+    vruntime += ticks * NICE_0_WEIGHT * NICE_0_WEIGHT / getWeight();
+}
 
+bool Process::declareVariable(const uint8_t slot, const uint16_t value) {
     // If we've reached max variables, ignore as per spec
-    if (variableAddresses.size() >= MAX_VARIABLES) {
+    if (slot == NO_SLOT) {
         return true;
     }
 
-    const auto symbolTableStart = segmentBoundaries[TEXT];
-    const uint16_t nextAddress = symbolTableStart + variableOrder.size() * VARIABLE_SIZE;
+    // Don't allow double declarations
+    if (isDeclared(slot)) {
+        return false;
+    }
+
+    const uint16_t address = getVariableAddress(slot);
 
     // Ensure we don't exceed required memory
-    if (nextAddress >= requiredMemory) {
+    if (address >= requiredMemory) {
         throw std::runtime_error("Memory exceeded during variable declaration");
     }
 
-    const auto [page, offset] = splitAddress(nextAddress);
+    const auto [page, offset] = splitAddress(address);
 
     // Ensure page is loaded
     safePageFault(page);
@@ -287,13 +508,19 @@ bool Process::declareVariable(const std::string& name, uint16_t value) {
     PagingAllocator::getInstance().writeToFrame(frame, offset, value);
     pageTable[page].isDirty = true;
 
-    // Track variable
-    variableAddresses[name] = nextAddress;
-    variableOrder.push_back(name);
+    declaredSlots |= 1u << slot;
 
     return true;
 }
 
+bool Process::isDeclared(const uint8_t slot) const {
+    return (declaredSlots & 1u << slot) != 0;
+}
+
+uint16_t Process::getVariableAddress(const uint8_t slot) const {
+    return segmentBoundaries.at(TEXT) + slot * VARIABLE_SIZE;
+}
+
 uint64_t Process::getRequiredMemory() const {
     return requiredMemory;
 }
@@ -394,11 +621,12 @@ PageData Process::getPageData(const int pageNumber) const {
     std::vector<std::optional<StoredData>> data;
     data.reserve((end - start) * 2);
 
+    const auto program = this->program.load();
+
     // Iterate through the memory
     for (int i = start; i < end; i += 2) {
         if (i < segmentBoundaries.at(TEXT)) {
-            auto instruction = instructions[i / INSTRUCTION_SIZE];
-            data.emplace_back(instruction);
+            data.emplace_back(program->getCode()[i / INSTRUCTION_SIZE]);
             data.emplace_back(std::nullopt);
         } else {
             // Will be 0 because no variables/memory has been written to yet
@@ -489,7 +717,6 @@ std::string Process::generateTimestamp() {
 }
 
 std::uint64_t Process::getMemoryUsage() const {
-    // std::lock_guard lock(variableMutex);
     uint64_t memoryUsage = 0;
     const auto pageSize = Config::getInstance().getMemPerFrame();
 
@@ -508,8 +735,9 @@ void Process::precomputeInstructionPages() {
     PageData currentPage(pageSize, std::nullopt);
     size_t offset = 0;
 
-    for (const auto& instr : instructions) {
-        const size_t size = instr->getLineCount() * INSTRUCTION_SIZE;
+    const auto program = this->program.load();
+    for (const auto& instr : program->getCode()) {
+        constexpr size_t size = INSTRUCTION_SIZE;
 
         for (size_t i = 0; i < size; ++i) {
             if (offset == pageSize) {
@@ -4,17 +4,26 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "Instruction.h"
+#include "Interpreter.h"
 #include "PagingAllocator.h"
+#include "Program.h"
 
 enum ProcessStatus { READY, RUNNING, WAITING, DONE };
+
+constexpr int LOWEST_PRIORITY = 9;  // Priorities go from 0 (highest) to this
+constexpr uint64_t NICE_0_WEIGHT = 1024;  // CFS weight of a priority 0 process
+constexpr uint64_t DEFAULT_TICKETS = 100;  // Lottery and stride tickets of a process without any given
+constexpr uint64_t STRIDE_1 = 1 << 20;     // Pass a stride scheduled process gains per tick, times its tickets
 enum MemorySegment { TEXT, DATA, HEAP };
 
 struct PageEntry {
@@ -26,6 +35,27 @@ struct PageEntry {
 
 using PageData = std::vector<std::optional<StoredData>>;
 
+// Tickets shared by a group of processes, split evenly between the ones that
+// haven't finished, so a tenant's share stays the same however many it runs
+struct TicketGroup {
+    std::string name;
+    uint64_t tickets = 0;
+    std::atomic<uint64_t> members = 0;
+};
+
+// A real-time process runs as a series of jobs, one released every period.
+// Each job needs budget ticks of CPU time, done within deadline ticks of its release.
+struct RealTimeParams {
+    uint64_t budget = 0;
+    uint64_t deadline = 0;
+    uint64_t period = 0;
+
+    /// @brief Share of a core the process needs to meet its deadlines.
+    [[nodiscard]] double density() const {
+        return static_cast<double>(budget) / static_cast<double>(std::min(deadline, period));
+    }
+};
+
 /**
  * @class Process
  * @brief Represents a simulated process with logging and line-tracking
@@ -82,13 +112,27 @@ public:
      * @param entry The log entry to add.
      */
     void log(const std::string& entry);
-    void safePageFault(int page) const;
+    void safePageFault(int page);
 
     /**
      * @brief Increments the current line number by 1, up to the total number of
      * lines.
      */
-    void incrementLine();
+    void incrementLine(const ExecutionContext& context);
+
+    /// @brief Runs the process for one tick, which executes a single line.
+    void step(const ExecutionContext& context);
+
+    /// @brief Starts counting the iterations of a loop, nested in any the
+    /// process is already running.
+    void enterLoop(uint16_t iterations);
+    /// @brief Counts an iteration of the innermost loop.
+    /// @return True if the loop goes around again, false once it's done.
+    bool nextIteration();
+
+    /// @brief Suspends the process until the given tick. The core that is
+    /// running it decides where it waits once the current line is done.
+    void sleepUntil(uint64_t tick);
 
     [[nodiscard]] ProcessStatus getStatus() const;
     void setStatus(ProcessStatus newStatus);
@@ -99,10 +143,60 @@ public:
 
     void setCurrentCore(int coreId);
     int getCurrentCore() const;
+
+    /// @brief Core the process last ran on, -1 if it never ran.
+    int getLastCore() const;
+
+    /// @brief Number of times the process resumed on a different core than
+    /// the one it last ran on.
+    uint64_t getMigrations() const;
+
+    /// @brief Records that the process is starting on the given core.
+    /// @return True if that is a migration from another core.
+    bool recordDispatch(int coreId);
+
+    /// @brief Records how the process gave up its last core, to tell CPU-bound
+    /// processes from ones that mostly sleep.
+    void recordBurst(bool usedFullQuantum);
+
+    /// @brief Whether the process tends to use up its quantum rather than sleep.
+    /// New processes are assumed to be.
+    bool isCpuBound() const;
+
+    /// @brief Number of accesses to frames on another NUMA node than the core
+    /// running the process.
+    uint64_t getRemoteAccesses() const;
+
+    /// @brief Remote accesses since the last call, so the core can charge for them.
+    uint64_t takePendingRemoteAccesses();
+
+    /// @brief Scheduling history, recorded by the scheduler as the process moves
+    /// between states. All in ticks.
+    void recordArrival(uint64_t tick);
+    bool hasArrived() const;
+    void recordReady(uint64_t tick);
+    /// @return How long the process waited in the ready queue.
+    uint64_t recordRunning(uint64_t tick);
+    void recordPreemption();
+    /// @return The turnaround time.
+    uint64_t recordDone(uint64_t tick);
+
+    /// @brief Ticks from arrival to first running, or -1 if it hasn't yet.
+    int64_t getResponseTime() const;
+    /// @brief Ticks from arrival to finishing, or -1 if it hasn't yet.
+    int64_t getTurnaroundTime() const;
+    uint64_t getReadyWait() const;
+    uint64_t getContextSwitches() const;
+    uint64_t getPreemptions() const;
+    /// @brief Compiles the instructions into the program of the process.
     void setInstructions(const std::vector<std::shared_ptr<Instruction>>& instructions, bool addToMemory = false);
-    bool setVariable(const std::string& name, uint16_t value);
+    /// @return Null once the process has finished.
+    std::shared_ptr<const Program> getProgram() const;
+    /// @brief Assigns to a declared variable, by symbol table slot.
+    bool setVariable(uint8_t slot, uint16_t value);
     bool getIsFinished() const;
-    uint16_t getVariable(const std::string& name);
+    /// @brief Reads a variable by symbol table slot, declaring it as 0 first if needed.
+    uint16_t getVariable(uint8_t slot);
     uint64_t getWakeupTick() const;
     void setWakeupTick(uint64_t value);
     void setLastInstructionCycle(const uint64_t cycle) {
@@ -112,7 +206,58 @@ public:
         return lastInstructionCycle;
     }
 
-    bool declareVariable(const std::string& name, uint16_t value);
+    /// @brief MLFQ priority level, 0 being the highest.
+    int getQueueLevel() const;
+    void setQueueLevel(int level);
+
+    /// @brief Static priority for the priority scheduler, 0 being the highest.
+    int getPriority() const;
+    void setPriority(int value);
+
+    /// @brief CFS weight derived from the priority, NICE_0_WEIGHT at priority 0.
+    uint64_t getWeight() const;
+
+    /// @brief Virtual runtime for the fair scheduler. Every tick a process runs
+    /// adds NICE_0_WEIGHT scaled down by its weight, so lower priority
+    /// processes age faster.
+    uint64_t getVruntime() const;
+    void setVruntime(uint64_t value);
+    void chargeVruntime(uint64_t ticks);
+
+    /// @brief Lottery and stride tickets, the process's share of its group's if
+    /// it is in one. Never less than one.
+    uint64_t getTickets() const;
+    void setTickets(uint64_t value);
+    void joinTicketGroup(const std::shared_ptr<TicketGroup>& group);
+    void leaveTicketGroup();
+    const std::shared_ptr<TicketGroup>& getTicketGroup() const;
+
+    /// @brief Pass for the stride scheduler. Every tick a process runs adds
+    /// STRIDE_1 divided by its tickets, the lowest pass runs next.
+    uint64_t getPass() const;
+    void setPass(uint64_t value);
+    void chargePass(uint64_t ticks);
+
+    /// @brief Puts the process in the real-time class with its first job
+    /// released on the given tick.
+    void makeRealTime(const RealTimeParams& params, uint64_t releaseTick);
+    bool isRealTime() const;
+    const RealTimeParams& getRealTimeParams() const;
+
+    /// @brief Absolute deadline and release tick of the current job.
+    uint64_t getJobDeadline() const;
+    uint64_t getJobRelease() const;
+
+    /// @brief Uses up a tick of the current job's budget.
+    /// @return True once the budget has run out.
+    bool chargeJobBudget();
+
+    /// @brief Ends the current job on the given tick and releases the next one.
+    /// @return True if the job missed its deadline.
+    bool completeJob(uint64_t tick);
+    uint64_t getDeadlineMisses() const;
+
+    bool declareVariable(uint8_t slot, uint16_t value);
     uint64_t getRequiredMemory() const;
     void setBaseAddress(void* ptr);
     void* getBaseAddress() const;
@@ -144,21 +289,51 @@ private:
     void* baseAddress = nullptr;
 
     int currentInstructionIndex;  ///< Current instruction being executed
+    std::vector<uint16_t> loopIterations;  ///< Left in each loop being run, innermost last
     std::string timestamp;        ///< Timestamp when the process was created.
     std::atomic<ProcessStatus> status;
     std::atomic<int> currentCore;
+    int lastCore = -1;
+    std::atomic<uint64_t> migrations = 0;
+    std::atomic<uint64_t> remoteAccesses = 0;
+    uint64_t pendingRemoteAccesses = 0;
+    static constexpr uint64_t NOT_YET = UINT64_MAX;
+    std::atomic<uint64_t> arrivalTick = NOT_YET;
+    std::atomic<uint64_t> firstRunTick = NOT_YET;
+    std::atomic<uint64_t> doneTick = NOT_YET;
+    uint64_t readySince = 0;
+    std::atomic<uint64_t> readyWait = 0;
+    std::atomic<uint64_t> contextSwitches = 0;
+    std::atomic<uint64_t> preemptions = 0;
+    int cpuBoundScore = 3;  // 0 to 3, up on every used up quantum, down on every sleep
     uint64_t wakeupTick;
     uint64_t lastInstructionCycle = 0;
+    int queueLevel = 0;
+    int priority = 0;
+    uint64_t vruntime = 0;
+    uint64_t tickets = DEFAULT_TICKETS;
+    std::shared_ptr<TicketGroup> ticketGroup;
+    uint64_t pass = 0;
+    std::optional<RealTimeParams> realTime;
+    uint64_t jobRelease = 0;
+    uint64_t jobDeadline = 0;
+    uint64_t jobBudgetLeft = 0;
+    std::atomic<uint64_t> deadlineMisses = 0;
 
     // Upper boundary of each memory segment(text, data, etc.)
     std::unordered_map<MemorySegment, uint16_t> segmentBoundaries;
 
-    std::vector<std::shared_ptr<Instruction>> instructions;
+    /// Possibly shared with other processes running the same text. Atomic because
+    /// another core's page fault may read it while this process finishes.
+    std::atomic<std::shared_ptr<const Program>> program;
     mutable std::mutex instructionsMutex;
 
-    std::unordered_map<std::string, uint16_t> variableAddresses;
-    std::vector<std::string> variableOrder;
-    mutable std::mutex variableMutex;
+    // Symbol table slots holding a declared variable. Only the core running
+    // the process touches them.
+    uint32_t declaredSlots;
+    static_assert(MAX_VARIABLES <= 32);
+    bool isDeclared(uint8_t slot) const;
+    uint16_t getVariableAddress(uint8_t slot) const;
 
     mutable std::mutex heapMutex;
 
@@ -169,6 +344,7 @@ private:
     std::vector<PageData> precomputedPages;
 
     bool isValidHeapAddress(int address) const;
+    void countFrameAccess(int frameNumber);
 
     bool didShutdown = false;
     std::string shutdownDetails;
@@ -1,25 +1,72 @@
 #include "ProcessScheduler.h"
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <print>
 #include <thread>
 
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "ConsoleManager.h"
+#include "CfsRunQueue.h"
+#include "FifoRunQueue.h"
 #include "FlatMemoryAllocator.h"  // Add this include
+#include "HeapRunQueue.h"
+#include "LotteryRunQueue.h"
+#include "MlfqRunQueue.h"
 #include "PagingAllocator.h"
 #include "Process.h"
+#include "Tracer.h"
 
 using namespace std::chrono_literals;
 
+// Points at the local tick of the core running on this thread, if any
+thread_local const uint64_t* currentCoreTick = nullptr;
+
+// Keys for the preemptive policies, the lowest one runs first
+static uint64_t remainingLinesKey(const Process& proc) {
+    return static_cast<uint64_t>(std::max(proc.getTotalLines() - proc.getCurrentLine(), 0));
+}
+
+static uint64_t priorityKey(const Process& proc) {
+    return static_cast<uint64_t>(proc.getPriority());
+}
+
+static uint64_t deadlineKey(const Process& proc) {
+    return proc.getJobDeadline();
+}
+
+static uint64_t passKey(const Process& proc) {
+    return proc.getPass();
+}
+
+// Best effort, platforms without affinity support just leave the thread as is
+static void pinToHostCpu(std::thread& thread, const unsigned cpu) {
+#ifdef _WIN32
+    SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{1} << cpu);
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
 ProcessScheduler& ProcessScheduler::getInstance() {
     static auto* instance = new ProcessScheduler();
     return *instance;
 }
 
 ProcessScheduler::ProcessScheduler() {
-    this->numCpuCores = Config::getInstance().getNumCPUs();
-    this->availableCores = Config::getInstance().getNumCPUs();
+    this->numPhysicalCores = Config::getInstance().getNumCPUs();
+    this->numCpuCores = numPhysicalCores * Config::getInstance().getSmtThreads();
+    this->availableCores = numCpuCores;
 };
 
 ProcessScheduler::~ProcessScheduler() {
@@ -32,7 +79,7 @@ ProcessScheduler::~ProcessScheduler() {
     if (dummyGeneratorThread.joinable())
         dummyGeneratorThread.join();
 
-    for (auto& t : cpuWorkers) {
+    for (auto& t : hostWorkers) {
         if (t.joinable())
             t.join();
     }
@@ -43,13 +90,21 @@ ProcessScheduler::~ProcessScheduler() {
 void ProcessScheduler::start() {
     running = true;
 
-    // Start CPU worker threads
-    for (int i = 0; i < numCpuCores; ++i) {
-        cpuWorkers.emplace_back(&ProcessScheduler::workerLoop, this, i);
+    // Start the host threads that the simulated cores are multiplexed onto. With
+    // only one, the tick thread resumes the cores itself.
+    const unsigned hostCpus = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 0; numHostThreads > 1 && i < numHostThreads; ++i) {
+        hostWorkers.emplace_back(&ProcessScheduler::hostWorkerLoop, this, i);
+
+        if (Config::getInstance().getPinHostThreads())
+            pinToHostCpu(hostWorkers.back(), i % hostCpus);
     }
 
     // Start ticking thread
     tickThread = std::thread(&ProcessScheduler::tickLoop, this);
+
+    if (hostWorkers.empty() && Config::getInstance().getPinHostThreads())
+        pinToHostCpu(tickThread, 0);
 }
 
 void ProcessScheduler::stop() {
@@ -65,14 +120,64 @@ int ProcessScheduler::getNumTotalCores() const {
     return numCpuCores;
 }
 
+int ProcessScheduler::getNumPhysicalCores() const {
+    return numPhysicalCores;
+}
+
+int ProcessScheduler::getSmtThreads() const {
+    return smtThreads;
+}
+
+std::vector<uint64_t> ProcessScheduler::getThreadActiveTicks() const {
+    std::vector<uint64_t> ticks;
+    for (const auto& core : cores) {
+        ticks.push_back(core.activeTicks.load(std::memory_order_relaxed));
+    }
+
+    return ticks;
+}
+
+std::vector<uint64_t> ProcessScheduler::getCoreBusyTicks() const {
+    std::vector<uint64_t> ticks;
+    for (const auto& busy : coreBusyTicks) {
+        ticks.push_back(busy.load(std::memory_order_relaxed));
+    }
+
+    return ticks;
+}
+
+// Parked cores only add their idle ticks once they unpark, so count the ones
+// they have built up so far
 uint64_t ProcessScheduler::getIdleCPUTicks() const {
-    return idleCpuTicks;
+    const uint64_t currentTick = totalCPUTicks;
+    uint64_t idle = idleCpuTicks;
+    for (const auto& core : cores) {
+        const uint64_t parkedAt = core.parkedAt.load(std::memory_order_relaxed);
+        if (parkedAt < currentTick)
+            idle += currentTick - parkedAt;
+    }
+
+    return idle;
 }
 
 uint64_t ProcessScheduler::getActiveCPUTicks() const {
     return activeCpuTicks;
 }
 
+uint64_t ProcessScheduler::getMigrations() const {
+    return migrations;
+}
+
+uint64_t ProcessScheduler::getRemoteAccesses() const {
+    return remoteAccesses;
+}
+
+// Cores are split into contiguous blocks, one per NUMA node. The threads of a
+// core always end up on the same node.
+int ProcessScheduler::getNodeOfCore(const int coreId) const {
+    return coreId / smtThreads * numaNodes / numPhysicalCores;
+}
+
 std::vector<std::shared_ptr<Process>> ProcessScheduler::getCoreAssignments() const {
     std::lock_guard lock(coreAssignmentsMutex);
 
@@ -80,56 +185,257 @@ std::vector<std::shared_ptr<Process>> ProcessScheduler::getCoreAssignments() con
 }
 
 void ProcessScheduler::initialize() {
-    this->numCpuCores = Config::getInstance().getNumCPUs();
-    this->availableCores = Config::getInstance().getNumCPUs();
-    coreAssignments.resize(numCpuCores);  // One slot per core
+    const auto& config = Config::getInstance();
 
-    tickBarrier =
-        std::make_unique<std::barrier<std::function<void()>>>(numCpuCores + 1, [this] { incrementCpuTicks(); });
+    this->smtThreads = config.getSmtThreads();
+    this->smtYield = config.getSmtYield();
+    this->numPhysicalCores = config.getNumCPUs();
+    this->numCpuCores = numPhysicalCores * smtThreads;
+    this->availableCores = numCpuCores;
+    coreAssignments.resize(numCpuCores);  // One slot per hardware thread
+
+    // Capacities are per core, every thread of it gets the same
+    cores = std::vector<CoreContext>(numCpuCores);
+    for (int i = 0; i < numCpuCores; ++i) {
+        cores[i].id = i;
+        cores[i].physicalCore = i / smtThreads;
+        cores[i].capacity = config.getCoreCapacity(cores[i].physicalCore);
+        cores[i].task = runCore(cores[i]);
+    }
+    coreBusyTicks = std::vector<std::atomic<uint64_t>>(numPhysicalCores);
+    idlePhysicalCores = numPhysicalCores;
+    parkedCores = 0;
+    Tracer::getInstance().initialize(numCpuCores, config.getTraceBuffer());
+
+    // Cores with the highest throughput are the big ones, unless they're all the same
+    const auto throughput = [](const CoreCapacity& capacity) {
+        return static_cast<double>(capacity.instructions) / capacity.period;
+    };
+    double bestThroughput = 0.0;
+    for (const auto& core : cores) {
+        bestThroughput = std::max(bestThroughput, throughput(core.capacity));
+    }
+
+    bigCores.clear();
+    littleCores.clear();
+    for (const auto& core : cores) {
+        (throughput(core.capacity) == bestThroughput ? bigCores : littleCores).push_back(core.id);
+    }
+    if (littleCores.empty())
+        bigCores.clear();
+    schedulerType = config.getSchedulerType();
+    preemptionKey = nullptr;
+    switch (schedulerType) {
+        case SchedulerType::FCFS:
+            levelQuantums = {UINT64_MAX};
+            break;
+        case SchedulerType::SRTF:
+            levelQuantums = {UINT64_MAX};
+            preemptionKey = remainingLinesKey;
+            break;
+        case SchedulerType::PRIORITY:
+            levelQuantums = {UINT64_MAX};
+            preemptionKey = priorityKey;
+            break;
+        case SchedulerType::CFS:
+            levelQuantums = {UINT64_MAX};  // Slices are worked out per process instead
+            break;
+        case SchedulerType::RR:
+        case SchedulerType::LOTTERY:
+        case SchedulerType::STRIDE:
+            levelQuantums = {config.getQuantumCycles()};
+            break;
+        case SchedulerType::MLFQ:
+            levelQuantums.clear();
+            for (int level = 0; level < config.getMlfqLevels(); ++level) {
+                levelQuantums.push_back(config.getMlfqQuantum(level));
+            }
+            break;
+    }
+    delayCycles = config.getDelaysPerExec();
+    migrationCost = config.getMigrationCost();
+    remoteAccessCost = config.getRemoteAccessCost();
+    numaNodes = config.getNumaNodes();
+    boostInterval = config.getMlfqBoostInterval();
+    lastBoostTick = totalCPUTicks;
+    cfsLatency = config.getCfsLatency();
+    cfsMinGranularity = config.getCfsMinGranularity();
+    fairSlice = cfsLatency;
+    minVruntime = 0;
+    globalPass = 0;
+
+    ticketGroups.clear();
+    for (const auto& [name, tickets] : config.getTicketGroups()) {
+        auto group = std::make_shared<TicketGroup>();
+        group->name = name;
+        group->tickets = tickets;
+        ticketGroups.push_back(std::move(group));
+    }
+
+    // Never more host threads than cores, by default as many as the host has
+    const int hostThreads = config.getHostThreads() != 0 ? static_cast<int>(config.getHostThreads())
+                                                         : static_cast<int>(std::thread::hardware_concurrency());
+    numHostThreads = std::clamp(hostThreads, 1, numPhysicalCores);
+
+    realTimeQueue = std::make_unique<HeapRunQueue>(deadlineKey);
+    runQueues.clear();
+    if (preemptionKey) {
+        runQueues.push_back(std::make_unique<HeapRunQueue>(preemptionKey));
+    } else {
+        for (int i = 0; i < numCpuCores; ++i) {
+            if (schedulerType == SchedulerType::MLFQ)
+                runQueues.push_back(std::make_unique<MlfqRunQueue>(config.getMlfqLevels()));
+            else if (schedulerType == SchedulerType::CFS)
+                runQueues.push_back(std::make_unique<CfsRunQueue>());
+            else if (schedulerType == SchedulerType::LOTTERY)
+                runQueues.push_back(std::make_unique<LotteryRunQueue>(i));
+            else if (schedulerType == SchedulerType::STRIDE)
+                runQueues.push_back(std::make_unique<HeapRunQueue>(passKey));
+            else
+                runQueues.push_back(std::make_unique<FifoRunQueue>());
+        }
+    }
+
+    // A single host thread runs the cores inline on the tick thread and needs no barrier
+    epochEnd = totalCPUTicks + 1;
+    tickBarrier = nullptr;
+    if (numHostThreads > 1) {
+        tickBarrier = std::make_unique<TickBarrier<EpochCompletion>>(numHostThreads + 1, EpochCompletion{this});
+    }
 }
 
 void ProcessScheduler::scheduleProcess(const std::shared_ptr<Process>& process) {
-    {
-        std::lock_guard lock(readyMutex);
-        readyQueue.push_back(process);
-    }
+    if (process->hasArrived())
+        process->recordReady(getCurrentTick());
+    else
+        process->recordArrival(getCurrentTick());
+
+    if (schedulerType == SchedulerType::CFS)
+        placeFairly(*process);
+    else if (schedulerType == SchedulerType::STRIDE)
+        placeByPass(*process);
+
+    queueProcess(process);
+}
+
+void ProcessScheduler::queueProcess(const std::shared_ptr<Process>& process) {
+    pickRunQueue(*process).push(process);
+    queueGeneration.fetch_add(1, std::memory_order_release);
 }
 
 void ProcessScheduler::sleepProcess(const std::shared_ptr<Process>& process) {
-    {
-        std::lock_guard lock(waitMutex);
-        this->waitQueue.push(process);
-    }
+    std::lock_guard lock(waitMutex);
+    this->waitQueue.insert(process, process->getWakeupTick());
 }
 
 uint64_t ProcessScheduler::getTotalCPUTicks() const {
     return totalCPUTicks;
 }
 
+// Cores can be ahead of totalCPUTicks within an epoch, so instructions use this
+uint64_t ProcessScheduler::getCurrentTick() const {
+    return currentCoreTick ? *currentCoreTick : totalCPUTicks.load();
+}
+
+double ProcessScheduler::getTickRate() const {
+    return tickRate;
+}
+
 void ProcessScheduler::incrementCpuTicks() {
+    totalCPUTicks = epochEnd.load();
+
     // Wakeup all sleeping processes that need to wakeup
     {
         std::lock_guard lock(waitMutex);
+        waitQueue.advanceTo(totalCPUTicks, wokenProcesses);
+    }
 
-        while (!waitQueue.empty() && waitQueue.top()->getWakeupTick() <= (totalCPUTicks + 1)) {
-            auto proc = waitQueue.top();
-            waitQueue.pop();
-
-            if (!proc)
-                continue;  // skip nulls
+    for (const auto& proc : wokenProcesses) {
+        if (!proc)
+            continue;  // skip nulls
 
-            if (proc->getIsFinished()) {
-                proc->setStatus(DONE);
-                PagingAllocator::getInstance().deallocate(proc->getID());
-            } else {
-                proc->setStatus(READY);
-                scheduleProcess(proc);
-            }
+        if (proc->getIsFinished()) {
+            proc->setStatus(DONE);
+            PagingAllocator::getInstance().deallocate(proc->getID());
+            retireProcess(*proc);
+        } else {
+            proc->setStatus(READY);
+            Tracer::getInstance().record(TraceEventType::WAKE, totalCPUTicks, proc->getID());
+            scheduleProcess(proc);
         }
     }
+    wokenProcesses.clear();
+
+    if (levelQuantums.size() > 1 && totalCPUTicks - lastBoostTick >= boostInterval) {
+        boostPriorities();
+        lastBoostTick = totalCPUTicks;
+    }
+
+    preemptForArrival();
+
+    if (schedulerType == SchedulerType::CFS)
+        updateFairShare();
+    else if (schedulerType == SchedulerType::STRIDE)
+        updateGlobalPass();
+
+    if (smtThreads > 1)
+        countIdlePhysicalCores();
 
+    fastForwardIdleTicks();
+    startNextEpoch();
     tickCv.notify_all();
-    ++totalCPUTicks;
+}
+
+// Decides how many ticks the cores may run before they next synchronize.
+// An epoch is only longer than one tick when no core could be handed a process
+// before it ends, so every core would spend it on its current process. An idle
+// core would have to wait out the epoch before taking a process created from
+// the console, where strict mode would start it on the next tick.
+void ProcessScheduler::startNextEpoch() {
+    const uint64_t currentTick = totalCPUTicks;
+    uint64_t length = Config::getInstance().getSyncEpoch();
+
+    if (length > 1 && (generatingDummies || getReadyCount() != 0 || availableCores != 0))
+        length = 1;
+
+    // End the epoch in time for the next sleeper to be picked up
+    if (length > 1) {
+        std::lock_guard lock(waitMutex);
+        if (const auto nextWakeup = waitQueue.getNextWakeupTick())
+            length = std::min(length, *nextWakeup - currentTick);
+    }
+
+    epochEnd = currentTick + length;
+}
+
+// Runs inside the barrier completion step, so every core is parked at the barrier
+void ProcessScheduler::fastForwardIdleTicks() {
+    // Rate limited ticks keep pace with the wall clock, skipping them would only
+    // make sleeps end early. Paying them back by sleeping through the skipped
+    // stretch instead would also hold up any process created in the meantime.
+    if (Config::getInstance().getTickMode() == TickMode::RATE_LIMITED)
+        return;
+
+    // Only skip when nothing could possibly run before the next wakeup
+    if (generatingDummies || availableCores != numCpuCores || getReadyCount() != 0)
+        return;
+
+    std::lock_guard lock(waitMutex);
+    const auto nextWakeup = waitQueue.getNextWakeupTick();
+    if (!nextWakeup)
+        return;
+
+    // The sleeper wakes up in the completion step of tick (wakeupTick - 1)
+    const uint64_t targetTick = *nextWakeup - 1;
+    const uint64_t currentTick = totalCPUTicks;
+    if (targetTick <= currentTick)
+        return;
+
+    // Credit the idle ticks every core would have spent waiting at the barrier,
+    // the parked ones are credited when they unpark
+    const uint64_t skipped = targetTick - currentTick;
+    idleCpuTicks += skipped * (numCpuCores - parkedCores);
+    totalCPUTicks = targetTick;
 }
 
 void ProcessScheduler::startDummyGeneration() {
@@ -187,62 +493,598 @@ bool ProcessScheduler::isGeneratingDummies() const {
     return generatingDummies;
 }
 
+size_t ProcessScheduler::getReadyCount() const {
+    size_t total = realTimeQueue->size();
+    for (const auto& queue : runQueues) {
+        total += queue->size();
+    }
+
+    return total;
+}
+
 void ProcessScheduler::printQueues() const {
-    std::println("Ready queue: {}", this->readyQueue.size());
-    std::println("Waiting queue: {}", this->waitQueue.size());
+    size_t waiting;
+    {
+        std::lock_guard lock(waitMutex);
+        waiting = this->waitQueue.size();
+    }
+
+    std::println("Ready queue: {}", getReadyCount());
+    std::println("Waiting queue: {}", waiting);
 }
 
 void ProcessScheduler::tickLoop() {
+    using Clock = std::chrono::steady_clock;
+
+    const auto tickMode = Config::getInstance().getTickMode();
+    const auto tickPeriod = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / Config::getInstance().getTickRate()));
+
+    auto nextTick = Clock::now();
+    auto windowStart = nextTick;
+    uint64_t windowTicks = totalCPUTicks;
+
     while (running) {
-        std::this_thread::sleep_for(1ms);  // Simulate one tick every 1ms
-        tickBarrier->arrive_and_wait();
+        if (tickMode == TickMode::RATE_LIMITED) {
+            nextTick += tickPeriod;
+
+            // If we fell behind (e.g. a slow tick), don't burst to catch up
+            const auto now = Clock::now();
+            if (nextTick + tickPeriod < now)
+                nextTick = now;
+
+            std::this_thread::sleep_until(nextTick);
+        }
+
+        // In free-run mode the next tick starts as soon as every core arrives
+        if (tickBarrier) {
+            tickBarrier->arriveAndWait(numHostThreads);
+        } else {
+            runCores(0);
+            incrementCpuTicks();
+        }
+
+        // An epoch spans several ticks, so pace it as such
+        if (tickMode == TickMode::RATE_LIMITED)
+            nextTick += tickPeriod * static_cast<int64_t>(epochEnd - totalCPUTicks - 1);
+
+        // Refresh the achieved tick rate about once a second
+        const auto now = Clock::now();
+        if (now - windowStart >= 1s) {
+            const uint64_t ticks = totalCPUTicks;
+            const double elapsed = std::chrono::duration<double>(now - windowStart).count();
+            tickRate = static_cast<double>(ticks - windowTicks) / elapsed;
+            windowStart = now;
+            windowTicks = ticks;
+        }
     }
-    tickBarrier->arrive_and_drop();
+    if (tickBarrier)
+        tickBarrier->arriveAndDrop(numHostThreads);
 }
 
-void ProcessScheduler::executeFCFS(const std::shared_ptr<Process>& proc, uint64_t& lastTickSeen) {
-    // FCFS: Run until process is finished or blocked
-    const uint32_t delayCycles = Config::getInstance().getDelaysPerExec();
-    while (proc && proc->getStatus() == RUNNING) {
-        if (!running)
-            break;
+// The body of a core coroutine, resumed once per tick
+Task ProcessScheduler::runCore(CoreContext& core) {
+    for (;;) {
+        if (!core.proc) {
+            // Processes are only handed out at the start of an epoch. Nothing
+            // queued anywhere means nothing to steal either, so park until
+            // something is. The generation is read first so a process queued
+            // while we look is never missed.
+            if (core.localTick == totalCPUTicks) {
+                const uint64_t generation = queueGeneration.load(std::memory_order_acquire);
+                dispatchProcess(core);
+                if (!core.proc && getReadyCount() == 0) {
+                    parkCore(core, generation);
+                    co_await std::suspend_always{};
+                    continue;
+                }
+            }
+
+            // Nothing to run, so sit out the rest of the epoch
+            if (!core.proc) {
+                idleCpuTicks += epochEnd - core.localTick;
+                core.localTick = epochEnd;
+                co_await std::suspend_always{};
+                continue;
+            }
+        }
+
+        const auto proc = core.proc;
+
+        // Still refilling the cache after a migration. The core is busy, but
+        // the process doesn't get anything done or use up its quantum.
+        if (core.stallTicks > 0) {
+            --core.stallTicks;
+            ++activeCpuTicks;
+            core.activeTicks.fetch_add(1, std::memory_order_relaxed);
+            ++core.localTick;
+            co_await std::suspend_always{};
+            continue;
+        }
 
-        lastTickSeen = totalCPUTicks;
+        // Little cores only get to execute every few ticks, big ones retire
+        // several instructions at once until the process blocks or finishes.
+        // Threads sharing a core with busy siblings miss some of their turns.
+        const bool executes = (delayCycles == 0 || core.localTick % delayCycles == 0) &&
+                              core.localTick % core.capacity.period == 0 && takeSmtSlot(core);
+        if (executes) {
+            const ExecutionContext context{*proc, core.id, core.localTick};
+            for (uint32_t i = 0; i < core.capacity.instructions; ++i) {
+                if (i > 0 && (proc->getStatus() != RUNNING || proc->getIsFinished()))
+                    break;
+                proc->step(context);
+            }
+            core.cyclesExecuted++;
 
-        if (delayCycles == 0 || totalCPUTicks % delayCycles == 0) {
-            proc->incrementLine();
+            // Memory on another node takes longer to get at, the core waits it out next
+            if (const uint64_t remote = proc->takePendingRemoteAccesses()) {
+                remoteAccesses += remote;
+                core.stallTicks += remote * remoteAccessCost;
+            }
         }
 
+        proc->chargeVruntime(1);
+        proc->chargePass(1);
         ++activeCpuTicks;
-        tickBarrier->arrive_and_wait();
+        core.activeTicks.fetch_add(1, std::memory_order_relaxed);
+        ++core.localTick;
+
+        // A real-time process that got through its budget for this period waits
+        // for the next job to be released, like it went to sleep until then
+        if (proc->isRealTime() && (proc->chargeJobBudget() || proc->getIsFinished())) {
+            if (proc->completeJob(core.localTick))
+                ++deadlineMisses;
+            if (!proc->getIsFinished() && proc->getJobRelease() > core.localTick) {
+                const uint64_t wakeup = proc->getStatus() == WAITING ? proc->getWakeupTick() : 0;
+                proc->sleepUntil(std::max(proc->getJobRelease(), wakeup));
+            }
+        }
+
+        if (proc->getIsFinished()) {
+            Tracer::getInstance().record(TraceEventType::FINISH, core.localTick, proc->getID());
+            releaseCore(core, false);
+        } else if (proc->getStatus() == WAITING) {
+            proc->recordBurst(false);
+            Tracer::getInstance().record(TraceEventType::SLEEP, core.localTick, proc->getID(), proc->getWakeupTick());
+
+            // If the process wakes up before the epoch ends, nobody else could
+            // have been given this core anyway, so just idle through the sleep
+            // and resume it on the tick strict mode would have picked it up on
+            const uint64_t resumeTick = std::max(proc->getWakeupTick(), core.localTick);
+            if (resumeTick < epochEnd) {
+                idleCpuTicks += resumeTick - core.localTick;
+                core.localTick = resumeTick;
+                core.cyclesExecuted = 0;
+                proc->setStatus(RUNNING);
+                Tracer::getInstance().record(TraceEventType::WAKE, resumeTick, proc->getID());
+                proc->recordReady(resumeTick);
+                countDispatch(core, *proc);
+            } else {
+                sleepProcess(proc);
+                releaseCore(core, false);
+            }
+        } else if (core.cyclesExecuted >= core.quantum) {
+            expireQuantum(core);
+        }
+
+        co_await std::suspend_always{};
     }
 }
 
-void ProcessScheduler::executeRR(const std::shared_ptr<Process>& proc, uint64_t& lastTickSeen) {
-    // Round Robin: Run for quantum cycles or until finished/blocked
-    uint32_t cyclesExecuted = 0;
-    const uint32_t delayCycles = Config::getInstance().getDelaysPerExec();
-    const auto quantumCycles = Config::getInstance().getQuantumCycles();
+void ProcessScheduler::parkCore(CoreContext& core, const uint64_t generation) {
+    core.parkedGeneration = generation;
+    core.parkedAt.store(core.localTick, std::memory_order_relaxed);
+    core.localTick = epochEnd;
+    ++parkedCores;
+}
 
-    while (proc && proc->getStatus() == RUNNING && cyclesExecuted < quantumCycles) {
-        if (!running)
-            break;
-        lastTickSeen = totalCPUTicks;
+// Only called at the start of an epoch, when the core could be handed a process.
+// The core was idle for every tick it spent parked.
+bool ProcessScheduler::unparkCore(CoreContext& core) {
+    if (queueGeneration.load(std::memory_order_acquire) == core.parkedGeneration)
+        return false;
 
-        if (delayCycles == 0 || totalCPUTicks % delayCycles == 0) {
-            proc->incrementLine();
-            cyclesExecuted++;
+    idleCpuTicks += core.localTick - core.parkedAt.load(std::memory_order_relaxed);
+    core.parkedAt.store(CoreContext::NOT_PARKED, std::memory_order_relaxed);
+    --parkedCores;
+    return true;
+}
+
+uint64_t ProcessScheduler::getQuantum(const Process& proc) const {
+    // Real-time processes keep the core until their budget runs out
+    if (proc.isRealTime())
+        return UINT64_MAX;
+
+    // Heavier processes get a proportionally longer share of the period
+    if (schedulerType == SchedulerType::CFS)
+        return std::max(cfsMinGranularity, fairSlice * proc.getWeight() / NICE_0_WEIGHT);
+
+    const auto level = std::min(static_cast<size_t>(proc.getQueueLevel()), levelQuantums.size() - 1);
+    return levelQuantums[level];
+}
+
+// A process that used up its whole quantum drops a level, if there is one
+void ProcessScheduler::expireQuantum(CoreContext& core) {
+    const auto& proc = core.proc;
+    proc->recordBurst(true);
+
+    if (proc->getQueueLevel() + 1 < static_cast<int>(levelQuantums.size()))
+        proc->setQueueLevel(proc->getQueueLevel() + 1);
+
+    // Mid-epoch the run queues are empty, so a preempted process would
+    // just be picked straight back up again
+    if (core.localTick < epochEnd) {
+        countPreemption(core, *proc);
+        countDispatch(core, *proc);
+        core.cyclesExecuted = 0;
+        core.quantum = getQuantum(*proc);
+    } else {
+        proc->setStatus(READY);
+        releaseCore(core, true);
+    }
+}
+
+// Moves every process back to the top level so the demoted ones can't starve.
+// Runs inside the barrier completion step, so no core is touching them.
+void ProcessScheduler::boostPriorities() {
+    const auto boost = [](Process& proc) { proc.setQueueLevel(0); };
+
+    for (const auto& queue : runQueues) {
+        queue->updateAll(boost);
+    }
+
+    for (auto& core : cores) {
+        if (core.proc) {
+            boost(*core.proc);
+            core.quantum = getQuantum(*core.proc);
         }
+    }
 
-        ++activeCpuTicks;
-        tickBarrier->arrive_and_wait();
+    std::lock_guard lock(waitMutex);
+    waitQueue.forEach([&](const std::shared_ptr<Process>& proc) { boost(*proc); });
+}
+
+// Lets a newly ready process take over the core of the worst running one when
+// it should be running instead. Runs inside the barrier completion step, so the
+// core picks it up at the start of the next tick. One preemption per tick is
+// plenty since processes are created and woken up a few at a time.
+void ProcessScheduler::preemptForArrival() {
+    // Idle cores will take the new arrivals anyway
+    if (availableCores != 0 || preemptForRealTime() || !preemptionKey)
+        return;
+
+    const auto best = runQueues.front()->peekKey();
+    if (!best)
+        return;
+
+    CoreContext* victim = nullptr;
+    uint64_t worstKey = 0;
+    for (auto& core : cores) {
+        if (!core.proc || core.proc->isRealTime())
+            continue;
+
+        const uint64_t key = preemptionKey(*core.proc);
+        if (!victim || key > worstKey) {
+            victim = &core;
+            worstKey = key;
+        }
     }
 
-    // If process used full quantum and is still running, preempt it
-    if (proc && proc->getStatus() == RUNNING && cyclesExecuted >= quantumCycles) {
-        proc->setStatus(READY);
-        scheduleProcess(proc);  // Put back at end of ready queue
+    if (victim && *best < worstKey) {
+        victim->proc->setStatus(READY);
+        releaseCore(*victim, true);
+    }
+}
+
+// A released real-time job takes the core of a process from a lower class, or
+// else of the real-time process with the latest deadline if its own is earlier
+bool ProcessScheduler::preemptForRealTime() {
+    const auto earliest = realTimeQueue->peekKey();
+    if (!earliest)
+        return false;
+
+    CoreContext* victim = nullptr;
+    for (auto& core : cores) {
+        if (!core.proc)
+            continue;
+
+        if (!core.proc->isRealTime()) {
+            victim = &core;
+            break;
+        }
+        if (!victim || core.proc->getJobDeadline() > victim->proc->getJobDeadline())
+            victim = &core;
+    }
+
+    if (!victim || (victim->proc->isRealTime() && victim->proc->getJobDeadline() <= *earliest))
+        return false;
+
+    victim->proc->setStatus(READY);
+    releaseCore(*victim, true);
+    return true;
+}
+
+// Global EDF on m cores meets every deadline as long as the total density stays
+// within m - (m - 1) * the largest density (Goossens, Funk and Baruah)
+bool ProcessScheduler::admitRealTime(const RealTimeParams& params) {
+    const double density = params.density();
+    const double cores = numCpuCores;
+
+    std::lock_guard lock(realTimeMutex);
+    const double largest = std::max(density, realTimeDensities.empty() ? 0.0 : *realTimeDensities.rbegin());
+    if (density > 1.0 || realTimeLoad + density > cores - (cores - 1.0) * largest)
+        return false;
+
+    realTimeDensities.insert(density);
+    realTimeLoad += density;
+    return true;
+}
+
+// Gives back the share of the cores a finished process had reserved or was
+// splitting with its ticket group
+void ProcessScheduler::retireProcess(Process& proc) {
+    turnaroundTimes.record(proc.recordDone(getCurrentTick()));
+    proc.leaveTicketGroup();
+    if (!proc.isRealTime())
+        return;
+
+    std::lock_guard lock(realTimeMutex);
+    const auto it = realTimeDensities.find(proc.getRealTimeParams().density());
+    if (it == realTimeDensities.end())
+        return;
+
+    realTimeDensities.erase(it);
+    realTimeLoad = std::max(0.0, realTimeLoad - proc.getRealTimeParams().density());
+}
+
+uint64_t ProcessScheduler::getDeadlineMisses() const {
+    return deadlineMisses;
+}
+
+const LatencyHistogram& ProcessScheduler::getResponseTimes() const {
+    return responseTimes;
+}
+
+const LatencyHistogram& ProcessScheduler::getReadyWaits() const {
+    return readyWaits;
+}
+
+const LatencyHistogram& ProcessScheduler::getTurnaroundTimes() const {
+    return turnaroundTimes;
+}
+
+uint64_t ProcessScheduler::getContextSwitches() const {
+    return contextSwitches;
+}
+
+uint64_t ProcessScheduler::getPreemptions() const {
+    return preemptions;
+}
+
+size_t ProcessScheduler::getNumRealTime() const {
+    std::lock_guard lock(realTimeMutex);
+    return realTimeDensities.size();
+}
+
+double ProcessScheduler::getRealTimeLoad() const {
+    std::lock_guard lock(realTimeMutex);
+    return realTimeLoad;
+}
+
+// Works out the CFS slice for the coming tick and moves min vruntime forward.
+// Every core should get through its share of the runnable processes within the
+// target latency, unless that would cut slices below the minimum granularity.
+// Runs inside the barrier completion step.
+void ProcessScheduler::updateFairShare() {
+    const uint64_t runnable = getReadyCount() + (numCpuCores - availableCores);
+    const uint64_t perCore = std::max<uint64_t>(1, (runnable + numCpuCores - 1) / numCpuCores);
+    const uint64_t period = std::max(cfsLatency, perCore * cfsMinGranularity);
+    fairSlice = period / perCore;
+
+    std::optional<uint64_t> lowest;
+    for (const auto& core : cores) {
+        if (core.proc)
+            lowest = std::min(lowest.value_or(UINT64_MAX), core.proc->getVruntime());
+    }
+    for (const auto& queue : runQueues) {
+        if (const auto key = queue->peekKey())
+            lowest = std::min(lowest.value_or(UINT64_MAX), *key);
+    }
+
+    if (lowest && *lowest > minVruntime)
+        minVruntime = *lowest;
+}
+
+// New processes start level with everyone else. Woken ones keep their vruntime,
+// but get at most half a latency of credit for the time they spent asleep, so a
+// long sleep can't be cashed in to hog the core afterwards.
+void ProcessScheduler::placeFairly(Process& proc) const {
+    const uint64_t floor = minVruntime;
+
+    if (proc.getCurrentLine() == 0 && proc.getVruntime() == 0) {
+        proc.setVruntime(floor);
+        return;
+    }
+
+    const uint64_t credit = cfsLatency * NICE_0_WEIGHT / 2;
+    proc.setVruntime(std::max(proc.getVruntime(), floor > credit ? floor - credit : 0));
+}
+
+// Moves the global pass up to the lowest pass of any running or queued process.
+// Runs inside the barrier completion step.
+void ProcessScheduler::updateGlobalPass() {
+    std::optional<uint64_t> lowest;
+    for (const auto& core : cores) {
+        if (core.proc && !core.proc->isRealTime())
+            lowest = std::min(lowest.value_or(UINT64_MAX), core.proc->getPass());
+    }
+    for (const auto& queue : runQueues) {
+        if (const auto key = queue->peekKey())
+            lowest = std::min(lowest.value_or(UINT64_MAX), *key);
     }
+
+    if (lowest && *lowest > globalPass)
+        globalPass = *lowest;
+}
+
+// New and woken processes join at the global pass, so a process that was
+// asleep can't catch up on the time it was away. One that was already ahead
+// keeps its pass.
+void ProcessScheduler::placeByPass(Process& proc) const {
+    proc.setPass(std::max(proc.getPass(), globalPass.load()));
+}
+
+std::shared_ptr<TicketGroup> ProcessScheduler::getTicketGroup(const std::string& name) const {
+    const auto it = std::ranges::find(ticketGroups, name, &TicketGroup::name);
+    return it != ticketGroups.end() ? *it : nullptr;
+}
+
+RunQueue& ProcessScheduler::getRunQueue(const int coreId) const {
+    return *runQueues[coreId % runQueues.size()];
+}
+
+// Real-time processes all share the one queue, so any core can pick them up.
+// Other processes go back to the core they last ran on while its cache is still
+// warm, as long as it's the right kind of core: CPU-bound processes belong on
+// the big cores and sleepy ones on the little cores. Everything else is spread
+// across the suitable cores, stealing evens it out later.
+RunQueue& ProcessScheduler::pickRunQueue(const Process& proc) {
+    if (proc.isRealTime())
+        return *realTimeQueue;
+
+    const int lastCore = proc.getLastCore();
+
+    if (!bigCores.empty()) {
+        const auto& suitable = proc.isCpuBound() ? bigCores : littleCores;
+        if (lastCore != -1 && std::ranges::find(suitable, lastCore) != suitable.end())
+            return getRunQueue(lastCore);
+
+        const uint32_t next = nextRunQueue.fetch_add(1, std::memory_order_relaxed);
+        return getRunQueue(suitable[next % suitable.size()]);
+    }
+
+    if (lastCore != -1)
+        return getRunQueue(lastCore);
+
+    const uint32_t next = nextRunQueue.fetch_add(1, std::memory_order_relaxed);
+    return getRunQueue(spreadAcrossCores(next));
+}
+
+// Maps the index-th placement to a hardware thread so that consecutive ones land
+// on different cores, and a core only gets a second thread used once every core
+// has one
+int ProcessScheduler::spreadAcrossCores(const uint32_t index) const {
+    const int physicalCore = static_cast<int>(index % numPhysicalCores);
+    const int thread = static_cast<int>(index / numPhysicalCores % smtThreads);
+    return physicalCore * smtThreads + thread;
+}
+
+// Decides whether a thread gets to execute this tick. With k of the n threads
+// of a core busy the core as a whole gets through 1 + (yield - 1)(k - 1)/(n - 1)
+// times what a lone thread would, split evenly between the busy ones. Each thread
+// builds up its share as credit and executes whenever it has a whole slot.
+bool ProcessScheduler::takeSmtSlot(CoreContext& core) const {
+    if (smtThreads == 1)
+        return true;
+
+    const auto busy = static_cast<uint32_t>(countBusyThreads(core.physicalCore));
+    if (busy <= 1) {
+        core.smtCredit = 0;
+        return true;
+    }
+
+    const uint32_t combined = 100 + (smtYield - 100) * (busy - 1) / (smtThreads - 1);
+    core.smtCredit += combined / busy;
+    if (core.smtCredit < 100)
+        return false;
+
+    core.smtCredit -= 100;
+    return true;
+}
+
+// Runs inside the barrier completion step, so every core is parked at the barrier
+void ProcessScheduler::countIdlePhysicalCores() {
+    int idle = 0;
+    for (int physicalCore = 0; physicalCore < numPhysicalCores; ++physicalCore) {
+        if (countBusyThreads(physicalCore) == 0)
+            ++idle;
+    }
+
+    idlePhysicalCores = idle;
+}
+
+int ProcessScheduler::countBusyThreads(const int physicalCore) const {
+    const auto first = cores.begin() + physicalCore * smtThreads;
+    return static_cast<int>(
+        std::count_if(first, first + smtThreads, [](const CoreContext& thread) { return thread.proc != nullptr; }));
+}
+
+size_t ProcessScheduler::getNumBigCores() const {
+    return bigCores.size();
+}
+
+void ProcessScheduler::dispatchProcess(CoreContext& core) {
+    // Real-time processes go first. Then get a process from our own queue,
+    // otherwise try to steal one. A thread whose core is already busy leaves
+    // the stealing to a wholly idle core while there is one, so the work
+    // doesn't end up sharing a core.
+    auto proc = realTimeQueue->pop();
+    if (!proc)
+        proc = getRunQueue(core.id).pop();
+    if (!proc && (idlePhysicalCores == 0 || countBusyThreads(core.physicalCore) == 0))
+        proc = stealProcess(core.id);
+
+    if (!proc)
+        return;
+
+    proc->setStatus(RUNNING);
+    proc->setCurrentCore(core.id);
+    {
+        std::lock_guard lock(coreAssignmentsMutex);
+        availableCores -= 1;
+        coreAssignments[core.id] = proc;
+    }
+
+    core.proc = proc;
+    core.cyclesExecuted = 0;
+    core.quantum = getQuantum(*proc);
+    core.stallTicks = 0;
+
+    countDispatch(core, *proc);
+    if (proc->recordDispatch(core.id)) {
+        ++migrations;
+        core.stallTicks = migrationCost;
+    }
+}
+
+void ProcessScheduler::releaseCore(CoreContext& core, const bool preempted) {
+    auto proc = core.proc;
+    resetCore(core.proc, core.id);
+
+    // Preempted processes go to the back of this core's queue, only once the
+    // core has been released so a thief can't race us
+    if (preempted) {
+        countPreemption(core, *proc);
+        queueProcess(proc);
+    }
+}
+
+// Within an epoch a process can get its core straight back without going
+// through the run queues, these keep the statistics the same as if it had
+void ProcessScheduler::countDispatch(const CoreContext& core, Process& proc) {
+    ++contextSwitches;
+    readyWaits.record(proc.recordRunning(core.localTick));
+    if (proc.getContextSwitches() == 1)
+        responseTimes.record(static_cast<uint64_t>(proc.getResponseTime()));
+
+    Tracer::getInstance().record(TraceEventType::DISPATCH, core.localTick, proc.getID());
+}
+
+void ProcessScheduler::countPreemption(const CoreContext& core, Process& proc) {
+    Tracer::getInstance().recordOn(core.id, TraceEventType::PREEMPT, getCurrentTick(), proc.getID());
+    ++preemptions;
+    proc.recordPreemption();
+    proc.recordReady(getCurrentTick());
 }
 
 void ProcessScheduler::resetCore(std::shared_ptr<Process>& proc, int coreId) {
@@ -252,6 +1094,7 @@ void ProcessScheduler::resetCore(std::shared_ptr<Process>& proc, int coreId) {
         proc->setStatus(DONE);
         // Deallocate memory for completed process
         PagingAllocator::getInstance().deallocate(proc->getID());
+        retireProcess(*proc);
     }
 
     // Reset current core to none
@@ -261,49 +1104,88 @@ void ProcessScheduler::resetCore(std::shared_ptr<Process>& proc, int coreId) {
     coreAssignments[coreId] = nullptr;  // Clear assignment
 }
 
-void ProcessScheduler::workerLoop(const int coreId) {
-    uint64_t lastTickSeen = 0;
-    std::shared_ptr<Process> proc = nullptr;
-    const auto schedulerType = Config::getInstance().getSchedulerType();
+// Steals from cores on the same NUMA node first, the process's memory is
+// more likely to be close by
+std::shared_ptr<Process> ProcessScheduler::stealProcess(const int thiefId) {
+    const int numQueues = static_cast<int>(runQueues.size());
+    const int thiefNode = getNodeOfCore(thiefId);
 
-    while (running) {
-        lastTickSeen = totalCPUTicks;
+    for (const bool sameNode : {true, false}) {
+        for (int i = 1; i < numQueues; ++i) {
+            const int victim = (thiefId + i) % numQueues;
+            if ((getNodeOfCore(victim) == thiefNode) != sameNode)
+                continue;
 
-        // Get a process from the queue
-        {
-            std::lock_guard lock(readyMutex);
+            if (auto proc = runQueues[victim]->steal())
+                return proc;
+        }
+    }
 
-            if (!readyQueue.empty()) {
-                proc = readyQueue.front();
-                readyQueue.pop_front();
+    return nullptr;
+}
 
-                proc->setStatus(RUNNING);
-                proc->setCurrentCore(coreId);
-                {
-                    std::lock_guard lock2(coreAssignmentsMutex);
-                    availableCores -= 1;
-                    coreAssignments[coreId] = proc;
-                }
+// Steps the threads of a core through the epoch in lockstep, so each one sees
+// what its siblings are doing on the same tick. A thread may be several ticks
+// ahead after idling, it just waits for the others to catch up. Parked threads
+// cost one check per epoch and aren't resumed at all, unless a process was
+// queued since they parked.
+void ProcessScheduler::runPhysicalCoreUntilEpochEnd(const int physicalCore) {
+    const auto first = cores.begin() + physicalCore * smtThreads;
+    const auto last = first + smtThreads;
+    for (auto thread = first; thread != last; ++thread) {
+        thread->localTick = totalCPUTicks;
+    }
+
+    while (running) {
+        const uint64_t tick = std::min_element(first, last, [](const CoreContext& a, const CoreContext& b) {
+                                  return a.localTick < b.localTick;
+                              })->localTick;
+        if (tick >= epochEnd)
+            break;
+
+        // A resume is either one active tick or some idle ones, so the core was
+        // busy on this tick if any thread's active count went up
+        bool busy = false;
+        for (auto thread = first; thread != last; ++thread) {
+            if (thread->localTick != tick)
+                continue;
+
+            if (thread->parkedAt.load(std::memory_order_relaxed) != CoreContext::NOT_PARKED && !unparkCore(*thread)) {
+                thread->localTick = epochEnd;
+                continue;
             }
-        }
 
-        if (!proc) {
-            idleCpuTicks += 1;
-            tickBarrier->arrive_and_wait();
-            continue;
+            // Instructions read the tick of whichever core is running on this thread
+            const uint64_t activeBefore = thread->activeTicks.load(std::memory_order_relaxed);
+            currentCoreTick = &thread->localTick;
+            Tracer::setCurrentCore(thread->id);
+            thread->task.resume();
+            busy |= thread->activeTicks.load(std::memory_order_relaxed) != activeBefore;
         }
 
-        // Execute process based on scheduler type
-        if (schedulerType == SchedulerType::FCFS) {
-            executeFCFS(proc, lastTickSeen);
-        } else {
-            executeRR(proc, lastTickSeen);
-        }
+        if (busy)
+            coreBusyTicks[physicalCore].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    currentCoreTick = nullptr;
+    Tracer::setCurrentCore(-1);
+}
 
-        resetCore(proc, coreId);
+// Runs every numHostThreads-th core, starting at the given one, through the epoch
+void ProcessScheduler::runCores(const int first) {
+    for (int physicalCore = first; physicalCore < numPhysicalCores; physicalCore += numHostThreads) {
+        runPhysicalCoreUntilEpochEnd(physicalCore);
+    }
+}
+
+// Each host thread owns a slice of the cores and meets the others at the barrier
+void ProcessScheduler::hostWorkerLoop(const int threadIndex) {
+    while (running) {
+        runCores(threadIndex);
+        tickBarrier->arriveAndWait(threadIndex);
     }
 
-    tickBarrier->arrive_and_drop();
+    tickBarrier->arriveAndDrop(threadIndex);
 }
 
 // DEPRECATED: This is for Flat Memory Allocator only
@@ -1,24 +1,45 @@
 #pragma once
 
 #include <atomic>
-#include <barrier>
 #include <condition_variable>
-#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <set>
 #include <thread>
 #include <vector>
 
 #include "Config.h"
+#include "HeapRunQueue.h"
+#include "LatencyHistogram.h"
 #include "Process.h"
-
-// For the min-heap waiting queue
-struct WakeupComparator {
-    bool operator()(const std::shared_ptr<Process>& a, const std::shared_ptr<Process>& b) const {
-        return a->getWakeupTick() > b->getWakeupTick();
-    }
+#include "RunQueue.h"
+#include "Task.h"
+#include "TickBarrier.h"
+#include "TimingWheel.h"
+
+// A simulated core, or one hardware thread of it with SMT. Each is a coroutine
+// that the host threads resume once per tick, so there can be far more of them
+// than threads.
+struct alignas(64) CoreContext {
+    static constexpr uint64_t NOT_PARKED = UINT64_MAX;
+
+    int id = 0;
+    int physicalCore = 0;  // Shared with the sibling threads
+    std::shared_ptr<Process> proc;
+    uint64_t localTick = 0;
+    uint64_t cyclesExecuted = 0;
+    uint64_t quantum = 0;      // Of the current process, depends on its queue level
+    uint64_t stallTicks = 0;   // Cache warm-up left after a migration, the process can't run yet
+    CoreCapacity capacity;
+    uint32_t smtCredit = 0;  // Percent of an execution slot built up while sharing the core
+    std::atomic<uint64_t> activeTicks = 0;
+
+    // An idle core with nothing queued anywhere parks instead of being resumed
+    // every tick, until a process is queued after the generation it saw
+    std::atomic<uint64_t> parkedAt = NOT_PARKED;  // Tick it parked on
+    uint64_t parkedGeneration = 0;
+    Task task;
 };
 
 class ProcessScheduler {
@@ -29,13 +50,43 @@ public:
     void stop();
     int getNumAvailableCores() const;
     int getNumTotalCores() const;
+    int getNumPhysicalCores() const;
+    int getSmtThreads() const;
+    std::vector<uint64_t> getThreadActiveTicks() const;
+    std::vector<uint64_t> getCoreBusyTicks() const;
     uint64_t getIdleCPUTicks() const;
     uint64_t getActiveCPUTicks() const;
+    uint64_t getMigrations() const;
+    uint64_t getRemoteAccesses() const;
+    int getNodeOfCore(int coreId) const;
+    size_t getNumBigCores() const;
     std::vector<std::shared_ptr<Process>> getCoreAssignments() const;
     void initialize();
     void scheduleProcess(const std::shared_ptr<Process>& process);
+
+    /// @brief Admission control for the real-time class. Reserves the process's
+    /// share of the cores if global EDF can still meet every deadline with it.
+    /// @return False if it would overload the cores.
+    bool admitRealTime(const RealTimeParams& params);
+    uint64_t getDeadlineMisses() const;
+
+    /// @brief Scheduling latency across every process, in ticks: from arrival to
+    /// first running, each stay in a ready queue, and from arrival to finishing.
+    const LatencyHistogram& getResponseTimes() const;
+    const LatencyHistogram& getReadyWaits() const;
+    const LatencyHistogram& getTurnaroundTimes() const;
+    uint64_t getContextSwitches() const;
+    uint64_t getPreemptions() const;
+
+    /// @brief The ticket group with the given name from the config, or null.
+    std::shared_ptr<TicketGroup> getTicketGroup(const std::string& name) const;
+    size_t getNumRealTime() const;
+    double getRealTimeLoad() const;
     void sleepProcess(const std::shared_ptr<Process>& process);
     uint64_t getTotalCPUTicks() const;
+    uint64_t getCurrentTick() const;
+    double getTickRate() const;
+    size_t getReadyCount() const;
     void printQueues() const;
     void startDummyGeneration();
     void stopDummyGeneration();
@@ -49,37 +100,138 @@ private:
     ProcessScheduler& operator=(const ProcessScheduler&) = delete;
 
     void tickLoop();
-    void workerLoop(int coreId);
+    void hostWorkerLoop(int threadIndex);
+    void runCores(int first);
+    void runPhysicalCoreUntilEpochEnd(int physicalCore);
+    Task runCore(CoreContext& core);
+    void parkCore(CoreContext& core, uint64_t generation);
+    bool unparkCore(CoreContext& core);
+    void queueProcess(const std::shared_ptr<Process>& process);
+    bool takeSmtSlot(CoreContext& core) const;
+    void countIdlePhysicalCores();
+    int countBusyThreads(int physicalCore) const;
+    int spreadAcrossCores(uint32_t index) const;
+    void dispatchProcess(CoreContext& core);
+    void releaseCore(CoreContext& core, bool preempted);
+    void countDispatch(const CoreContext& core, Process& proc);
+    void countPreemption(const CoreContext& core, Process& proc);
     void incrementCpuTicks();
+    void fastForwardIdleTicks();
+    void startNextEpoch();
+    uint64_t getQuantum(const Process& proc) const;
+    void expireQuantum(CoreContext& core);
+    void boostPriorities();
+    void preemptForArrival();
+    bool preemptForRealTime();
+    void retireProcess(Process& proc);
+    void updateFairShare();
+    void placeFairly(Process& proc) const;
+    void updateGlobalPass();
+    void placeByPass(Process& proc) const;
+    RunQueue& getRunQueue(int coreId) const;
+    RunQueue& pickRunQueue(const Process& proc);
     void dummyGeneratorLoop();
-    void executeFCFS(const std::shared_ptr<Process>& proc, uint64_t& lastTickSeen);
-    void executeRR(const std::shared_ptr<Process>& proc, uint64_t& lastTickSeen);
+    std::shared_ptr<Process> stealProcess(int thiefId);
 
     // Memory management methods
     bool tryAllocateMemory(std::shared_ptr<Process>& proc);
     void deallocateProcessMemory(const std::shared_ptr<Process>& proc) const;
     void resetCore(std::shared_ptr<Process>& proc, int coreId);
 
-    int numCpuCores;
+    int numCpuCores;  // Hardware threads, a core with SMT has several
+    int numPhysicalCores;
+    int numHostThreads = 1;
     std::atomic<int> availableCores;
+    std::vector<CoreContext> cores;
+
+    // SMT. The threads of a core are next to each other in cores and always run
+    // on the same host thread, so they can see what their siblings are doing.
+    int smtThreads = 1;
+    uint32_t smtYield = 100;
+    std::vector<std::atomic<uint64_t>> coreBusyTicks;  // Ticks with any thread of the core busy
+    int idlePhysicalCores = 0;                         // As of the start of the epoch
+
+    // Cached from the config since they're read on every tick. There is one
+    // quantum per queue level, FCFS and RR only have the one level.
+    SchedulerType schedulerType = SchedulerType::RR;
+    std::vector<uint64_t> levelQuantums;
+    uint64_t delayCycles = 0;
+    uint64_t migrationCost = 0;
+    uint64_t remoteAccessCost = 0;
+    int numaNodes = 1;
+
+    // Only filled in when the cores don't all have the same capacity
+    std::vector<int> bigCores;
+    std::vector<int> littleCores;
+    uint64_t boostInterval = 0;
+    uint64_t lastBoostTick = 0;
+
     std::vector<std::shared_ptr<Process>> coreAssignments;
     mutable std::mutex coreAssignmentsMutex;
 
-    std::deque<std::shared_ptr<Process>> readyQueue;
-    std::mutex readyMutex;
-
-    std::priority_queue<std::shared_ptr<Process>, std::vector<std::shared_ptr<Process>>, WakeupComparator> waitQueue;
-    std::mutex waitMutex;
+    // One ready queue per core, idle cores steal from the others. Policies that
+    // need a global order (SRTF, priority) share a single queue between all cores.
+    std::vector<std::unique_ptr<RunQueue>> runQueues;
+    HeapRunQueue::KeyFunction preemptionKey = nullptr;  // Set for the preemptive policies
+
+    // Real-time processes come before everything else, earliest deadline first.
+    // The densities of the admitted ones are kept for admission control.
+    std::unique_ptr<RunQueue> realTimeQueue;
+    std::multiset<double> realTimeDensities;
+    double realTimeLoad = 0.0;
+    mutable std::mutex realTimeMutex;
+    std::atomic<uint64_t> deadlineMisses = 0;
+
+    // CFS state. The slice is recomputed every tick from the number of runnable
+    // processes, and min vruntime only ever moves forward.
+    uint64_t cfsLatency = 0;
+    uint64_t cfsMinGranularity = 0;
+    uint64_t fairSlice = 0;
+    std::atomic<uint64_t> minVruntime = 0;
+    std::atomic<uint32_t> nextRunQueue = 0;
+
+    // Stride state. Global pass is the lowest pass of any runnable process,
+    // where new and woken ones start so they can't bank CPU time.
+    std::atomic<uint64_t> globalPass = 0;
+    std::vector<std::shared_ptr<TicketGroup>> ticketGroups;
+
+    // Sleeping processes keyed by wakeup tick
+    TimingWheel waitQueue;
+    std::vector<std::shared_ptr<Process>> wokenProcesses;  // Scratch buffer, reused every tick
+    mutable std::mutex waitMutex;
 
     std::condition_variable tickCv;
     std::mutex tickMutex;
-    std::atomic<int> coresFinishedThisTick = 0;
-    std::unique_ptr<std::barrier<std::function<void()>>> tickBarrier;
-
-    std::vector<std::thread> cpuWorkers;
+    // Completion step of the host threads' barrier, called directly by it
+    struct EpochCompletion {
+        ProcessScheduler* scheduler;
+        void operator()() const {
+            scheduler->incrementCpuTicks();
+        }
+    };
+    std::unique_ptr<TickBarrier<EpochCompletion>> tickBarrier;  // The tick thread is the last participant
+
+    std::vector<std::thread> hostWorkers;
     std::atomic<uint64_t> totalCPUTicks{0};
+
+    // Cores run on their own local tick until the end of the current epoch, which
+    // is totalCPUTicks + 1 in strict mode. Only the barrier completion moves it.
+    std::atomic<uint64_t> epochEnd{1};
+    std::atomic<double> tickRate = 0.0;  // Achieved ticks per second, measured by the tick thread
     std::atomic<uint64_t> activeCpuTicks = 0;
-    std::atomic<uint64_t> idleCpuTicks = 0;
+    std::atomic<uint64_t> idleCpuTicks = 0;  // Not counting the ticks of cores still parked
+
+    // Bumped whenever a process is queued, which is the only thing that can give
+    // a parked core work
+    std::atomic<uint64_t> queueGeneration = 0;
+    std::atomic<int> parkedCores = 0;
+    std::atomic<uint64_t> migrations = 0;
+    std::atomic<uint64_t> remoteAccesses = 0;
+    std::atomic<uint64_t> contextSwitches = 0;
+    std::atomic<uint64_t> preemptions = 0;
+    LatencyHistogram responseTimes;
+    LatencyHistogram readyWaits;
+    LatencyHistogram turnaroundTimes;
     std::atomic<bool> running{false};
 
     std::thread dummyGeneratorThread;
@@ -1,7 +1,9 @@
 #include "ProcessScreen.h"
 
+#include "Config.h"
 #include "ConsoleManager.h"
 // #include "Process.h"
+#include <format>
 #include <iostream>
 #include <print>
 
@@ -32,6 +34,20 @@ void ProcessScreen::render() {
     std::println("\033[1m{:>20}:\033[0m {}", "Name", processPtr->getName());
     std::println("\033[1m{:>20}:\033[0m {}", "Timestamp", processPtr->getTimestamp());
     std::println("\033[1m{:>20}:\033[0m {}/{}", "Instruction Line", processPtr->getCurrentLine(), processPtr->getTotalLines());
+    std::println("\033[1m{:>20}:\033[0m {}", "Core Migrations", processPtr->getMigrations());
+    std::println("\033[1m{:>20}:\033[0m {}", "Remote Accesses", processPtr->getRemoteAccesses());
+    if (const auto type = Config::getInstance().getSchedulerType();
+        type == SchedulerType::LOTTERY || type == SchedulerType::STRIDE) {
+        const auto& group = processPtr->getTicketGroup();
+        std::println("\033[1m{:>20}:\033[0m {}{}", "Tickets", processPtr->getTickets(),
+                     group ? std::format(" (share of group {})", group->name) : "");
+    }
+    if (processPtr->isRealTime()) {
+        const auto& params = processPtr->getRealTimeParams();
+        std::println("\033[1m{:>20}:\033[0m {} every {} ticks, within {}", "Real-Time Budget", params.budget,
+                     params.period, params.deadline);
+        std::println("\033[1m{:>20}:\033[0m {}", "Deadline Misses", processPtr->getDeadlineMisses());
+    }
 
     // Show memory violation if shutdown occurred
     if (processPtr->isShutdown()) {
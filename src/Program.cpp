@@ -0,0 +1,229 @@
+#include "Program.h"
+
+#include <algorithm>
+#include <format>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "Instruction.h"
+#include "InstructionFactory.h"
+#include "StringPool.h"
+
+// Every program a process is running, by hash, so identical ones are shared
+static std::mutex sharedMutex;
+static std::unordered_multimap<size_t, std::weak_ptr<const Program>> sharedPrograms;
+static size_t sweepAt = 64;
+
+std::shared_ptr<const Program> Program::compile(const std::vector<std::shared_ptr<Instruction>>& instructions) {
+    Program program;
+    for (const auto& instruction : instructions) {
+        instruction->compile(program);
+    }
+
+    return share(std::move(program));
+}
+
+std::shared_ptr<const Program> Program::share(Program&& program) {
+    const size_t key = program.hash();
+
+    std::lock_guard lock(sharedMutex);
+    const auto [first, last] = sharedPrograms.equal_range(key);
+    for (auto it = first; it != last; ++it) {
+        if (auto shared = it->second.lock(); shared && *shared == program)
+            return shared;
+    }
+
+    // Forget the programs nobody runs anymore every now and then
+    if (sharedPrograms.size() >= sweepAt) {
+        std::erase_if(sharedPrograms, [](const auto& entry) { return entry.second.expired(); });
+        sweepAt = std::max<size_t>(64, sharedPrograms.size() * 2);
+    }
+
+    auto shared = std::make_shared<const Program>(std::move(program));
+    sharedPrograms.emplace(key, shared);
+    return shared;
+}
+
+Program::~Program() {
+    auto& pool = StringPool::getInstance();
+    for (const auto* string : strings) {
+        pool.release(string);
+    }
+    for (const auto* name : variables) {
+        pool.release(name);
+    }
+}
+
+size_t Program::hash() const {
+    size_t seed = code.size();
+    const auto combine = [&](const size_t value) { seed ^= value + 0x9E3779B97F4A7C15 + (seed << 6) + (seed >> 2); };
+
+    for (const auto& instruction : code) {
+        combine(static_cast<size_t>(instruction.opcode) | static_cast<size_t>(instruction.flags) << 8 |
+                static_cast<size_t>(instruction.a) << 16 | static_cast<size_t>(instruction.b) << 32 |
+                static_cast<size_t>(instruction.c) << 48);
+    }
+    for (const auto* string : strings) {
+        combine(std::hash<const std::string*>{}(string));
+    }
+    for (const auto* name : variables) {
+        combine(std::hash<const std::string*>{}(name));
+    }
+
+    return seed;
+}
+
+bool Program::operator==(const Program& other) const {
+    return code == other.code && strings == other.strings && variables == other.variables && slots == other.slots;
+}
+
+void Program::push(const Bytecode& instruction) {
+    code.push_back(instruction);
+}
+
+uint16_t Program::intern(const std::string& text) {
+    auto& pool = StringPool::getInstance();
+    const std::string* pooled = pool.acquire(text);
+    if (const auto it = stringIndices.find(pooled); it != stringIndices.end()) {
+        pool.release(pooled);
+        return it->second;
+    }
+
+    if (strings.size() > UINT16_MAX) {
+        pool.release(pooled);
+        throw std::runtime_error("Program has too many distinct strings.");
+    }
+
+    const auto index = static_cast<uint16_t>(strings.size());
+    strings.push_back(pooled);
+    stringIndices.emplace(pooled, index);
+    return index;
+}
+
+const std::string& Program::getString(const uint16_t index) const {
+    return *strings[index];
+}
+
+uint16_t Program::variable(const std::string& name, const bool declares) {
+    auto& pool = StringPool::getInstance();
+    const std::string* pooled = pool.acquire(name);
+    auto it = variableIndices.find(pooled);
+    if (it != variableIndices.end()) {
+        pool.release(pooled);
+    } else {
+        if (variables.size() > UINT16_MAX) {
+            pool.release(pooled);
+            throw std::runtime_error("Program has too many distinct variables.");
+        }
+
+        it = variableIndices.emplace(pooled, static_cast<uint16_t>(variables.size())).first;
+        variables.push_back(pooled);
+        slots.push_back(NO_SLOT);
+    }
+
+    const uint16_t index = it->second;
+    if (declares && slots[index] == NO_SLOT && usedSlots < MAX_VARIABLES)
+        slots[index] = static_cast<uint8_t>(usedSlots++);
+
+    return index;
+}
+
+const std::string& Program::getVariableName(const uint16_t index) const {
+    return *variables[index];
+}
+
+const std::vector<Bytecode>& Program::getCode() const {
+    return code;
+}
+
+size_t Program::size() const {
+    return code.size();
+}
+
+std::string Program::disassemble(const Bytecode& instruction, const int pid) const {
+    const auto operand = [&](const OperandFlags flag, const uint16_t value) {
+        return instruction.isVar(flag) ? getVariableName(value) : std::to_string(value);
+    };
+
+    switch (instruction.opcode) {
+        case Opcode::PRINT: {
+            const bool hasVar = instruction.isVar(B_IS_VAR);
+            const bool hasName = (instruction.flags & A_HAS_NAME) != 0;
+            std::ostringstream oss;
+
+            oss << "PRT " << pid << ' ' << hasVar << ' ';
+            if (hasVar)
+                oss << getVariableName(instruction.b) << ' ';
+
+            oss << hasName << ' ';
+            if (hasName)
+                oss << instruction.c << ' ';
+
+            oss << std::quoted(getString(instruction.a));
+            return oss.str();
+        }
+        case Opcode::DECLARE:
+            return std::format("DCL {} {} {}", getVariableName(instruction.a), instruction.b, pid);
+        case Opcode::ADD:
+        case Opcode::SUB:
+            return std::format("{} {} {} {} {}", instruction.opcode == Opcode::ADD ? "ADD" : "SUB",
+                               getVariableName(instruction.a), operand(B_IS_VAR, instruction.b),
+                               operand(C_IS_VAR, instruction.c), pid);
+        case Opcode::SLEEP:
+            return std::format("SLP {} {}", instruction.a, pid);
+        case Opcode::WRITE:
+            return std::format("W {} {} {} {}", instruction.isVar(A_IS_VAR), instruction.getAddress(),
+                               operand(A_IS_VAR, instruction.a), pid);
+        case Opcode::READ:
+            return std::format("R {} {} {}", getVariableName(instruction.a), instruction.getAddress(), pid);
+        case Opcode::LOOP:
+            return std::format("LOOP {} {} {}", instruction.a, instruction.getTarget(), pid);
+        case Opcode::END_LOOP:
+            return std::format("ENDLOOP {} {}", instruction.getTarget(), pid);
+    }
+
+    throw std::runtime_error(std::format("Unknown opcode {}", static_cast<int>(instruction.opcode)));
+}
+
+Bytecode Program::assemble(std::istream& is) const {
+    // Loops are written out as their two halves, which only exist as bytecode
+    const auto start = is.tellg();
+    std::string type;
+    is >> type;
+
+    if (type == "LOOP" || type == "ENDLOOP") {
+        Bytecode bytecode{type == "LOOP" ? Opcode::LOOP : Opcode::END_LOOP};
+        int target;
+        if (bytecode.opcode == Opcode::LOOP)
+            is >> bytecode.a;
+        is >> target;
+        bytecode.setTarget(target);
+        return bytecode;
+    }
+
+    // Anything else is encoded into a scratch program, whose strings and
+    // variables are then swapped for the indices they have in this one
+    is.seekg(start);
+    Program scratch;
+    Bytecode bytecode = InstructionFactory::deserializeInstruction(is)->encode(scratch);
+
+    const auto find = [](const auto& indices, const std::string* pooled) {
+        const auto it = indices.find(pooled);
+        if (it == indices.end())
+            throw std::runtime_error(std::format("'{}' isn't part of the program.", *pooled));
+        return it->second;
+    };
+
+    if (bytecode.opcode == Opcode::PRINT)
+        bytecode.a = find(stringIndices, scratch.strings[bytecode.a]);
+    if (bytecode.isVar(A_IS_VAR))
+        bytecode.a = find(variableIndices, scratch.variables[bytecode.a]);
+    if (bytecode.isVar(B_IS_VAR))
+        bytecode.b = find(variableIndices, scratch.variables[bytecode.b]);
+    if (bytecode.isVar(C_IS_VAR))
+        bytecode.c = find(variableIndices, scratch.variables[bytecode.c]);
+
+    return bytecode;
+}
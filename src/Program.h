@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Instruction;
+
+// Entries in the symbol table of a process
+constexpr int MAX_VARIABLES = 32;
+// Slot of a variable that never fits in the symbol table
+constexpr uint8_t NO_SLOT = UINT8_MAX;
+
+enum class Opcode : uint8_t { PRINT, DECLARE, ADD, SUB, SLEEP, WRITE, READ, LOOP, END_LOOP };
+
+// Operands a, b and c that hold a variable instead of a literal value
+enum OperandFlags : uint8_t {
+    A_IS_VAR = 1 << 0,
+    B_IS_VAR = 1 << 1,
+    C_IS_VAR = 1 << 2,
+    // The process name goes into message a at offset c
+    A_HAS_NAME = 1 << 3,
+};
+
+/// @brief One instruction in its executable form, fixed width so a program is
+/// a flat array of these. Messages are indices into the string table of the
+/// program and variables into its variable table. Addresses and jump targets
+/// take up both b and c.
+///
+///   PRINT    a = message, b = variable to append if B_IS_VAR, c = where the
+///            process name goes if A_HAS_NAME
+///   DECLARE  a = variable, b = value
+///   ADD/SUB  a = result variable, b = lhs, c = rhs
+///   SLEEP    a = ticks
+///   WRITE    a = value, b/c = address
+///   READ     a = variable, b/c = address
+///   LOOP     a = iterations, b/c = index of its END_LOOP
+///   END_LOOP b/c = index of its LOOP
+struct Bytecode {
+    Opcode opcode;
+    uint8_t flags = 0;
+    uint16_t a = 0;
+    uint16_t b = 0;
+    uint16_t c = 0;
+
+    [[nodiscard]] bool isVar(const OperandFlags operand) const {
+        return (flags & operand) != 0;
+    }
+
+    [[nodiscard]] int getAddress() const {
+        return static_cast<int>(static_cast<uint32_t>(b) | static_cast<uint32_t>(c) << 16);
+    }
+    void setAddress(const int address) {
+        b = static_cast<uint16_t>(static_cast<uint32_t>(address) & 0xFFFF);
+        c = static_cast<uint16_t>(static_cast<uint32_t>(address) >> 16);
+    }
+
+    [[nodiscard]] int getTarget() const {
+        return getAddress();
+    }
+    void setTarget(const int index) {
+        setAddress(index);
+    }
+
+    bool operator==(const Bytecode&) const = default;
+
+    /// @brief Loop instructions only move the program counter, they don't take
+    /// up a line of their own.
+    [[nodiscard]] bool isControl() const {
+        return opcode == Opcode::LOOP || opcode == Opcode::END_LOOP;
+    }
+};
+static_assert(sizeof(Bytecode) == 8);
+
+/// @class Program
+/// @brief The bytecode of a process along with the strings it refers to.
+///
+/// Built once from the instructions the factory generates or parses, which are
+/// thrown away afterwards, and never changed after that. Processes with the
+/// same text share one program, and execution state such as the program
+/// counter and loop iterations lives in the process. The strings themselves
+/// are in the StringPool, the program only keeps its own table of indices to
+/// them and releases them when it's destroyed. Messages that name the process
+/// running them leave the name out, so they stay the same from one process
+/// to the next.
+///
+/// Variables get their symbol table slot while compiling, in the order the
+/// program first declares them when run, so executing an instruction indexes
+/// straight into the table instead of looking the name up.
+class Program {
+public:
+    Program() = default;
+    Program(Program&&) = default;
+    Program& operator=(Program&&) = delete;
+    ~Program();
+
+    /// @brief Compiles the instructions in order.
+    /// @return The program, shared with any other process that has the same one.
+    static std::shared_ptr<const Program> compile(const std::vector<std::shared_ptr<Instruction>>& instructions);
+
+    /// @brief Only used by instructions while they're compiled.
+    void push(const Bytecode& instruction);
+
+    /// @return Index of the string in the string table, added if it's new.
+    uint16_t intern(const std::string& text);
+    [[nodiscard]] const std::string& getString(uint16_t index) const;
+
+    /// @brief Adds the variable if it's new. Instructions that declare it
+    /// when run also give it the next free slot, if there's one left.
+    /// @return Index of the variable in the variable table.
+    uint16_t variable(const std::string& name, bool declares);
+    [[nodiscard]] const std::string& getVariableName(uint16_t index) const;
+    /// @return Symbol table slot of the variable, or NO_SLOT.
+    [[nodiscard]] uint8_t getSlot(uint16_t index) const {
+        return slots[index];
+    }
+
+    [[nodiscard]] const std::vector<Bytecode>& getCode() const;
+    [[nodiscard]] size_t size() const;
+
+    /// @brief The instruction in the text format of Instruction::serialize.
+    [[nodiscard]] std::string disassemble(const Bytecode& instruction, int pid) const;
+
+    /// @brief Reads back a single instruction written by disassemble.
+    Bytecode assemble(std::istream& is) const;
+
+    bool operator==(const Program& other) const;
+
+private:
+    [[nodiscard]] size_t hash() const;
+    static std::shared_ptr<const Program> share(Program&& program);
+
+    std::vector<Bytecode> code;
+
+    // Pooled, so the pointers can be compared and hashed instead of the strings
+    std::vector<const std::string*> strings;
+    std::unordered_map<const std::string*, uint16_t> stringIndices;
+
+    std::vector<const std::string*> variables;
+    std::vector<uint8_t> slots;  // Per variable
+    std::unordered_map<const std::string*, uint16_t> variableIndices;
+    int usedSlots = 0;
+};
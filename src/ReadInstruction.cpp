@@ -1,20 +1,21 @@
 #include "ReadInstruction.h"
 
-#include <sstream>
-
-#include "Process.h"
+#include <format>
 
 ReadInstruction::ReadInstruction(const std::string& variableName, int address, int pid)
     : Instruction(1, pid), variableName(variableName), address(address) {
-    this->opCode = "READ";
 }
 
-void ReadInstruction::execute() {
-    const auto proc = getProcess();
-    uint16_t value = proc->readFromHeap(address);
-    proc->declareVariable(variableName, value);
+Bytecode ReadInstruction::encode(Program& program) const {
+    Bytecode bytecode{Opcode::READ, A_IS_VAR, program.variable(variableName, true)};
+    bytecode.setAddress(address);
+    return bytecode;
 }
 
 std::string ReadInstruction::serialize() const {
     return std::format("R {} {} {}", variableName, address, pid);
-}
\ No newline at end of file
+}
+
+std::shared_ptr<ReadInstruction> ReadInstruction::relocated(const int offset) const {
+    return std::make_shared<ReadInstruction>(variableName, address + offset, pid);
+}
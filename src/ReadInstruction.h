@@ -4,10 +4,13 @@
 class ReadInstruction final : public Instruction {
 public:
     ReadInstruction(const std::string& variableName, int address, int pid);
-    void execute() override;
+    Bytecode encode(Program& program) const override;
     std::string serialize() const override;
 
+    /// @brief A copy reading from the address this many bytes further on.
+    std::shared_ptr<ReadInstruction> relocated(int offset) const;
+
 private:
-    std::string variableName;
-    int address;
+    const std::string variableName;
+    const int address;
 };
@@ -0,0 +1,61 @@
+#include "RunQueue.h"
+
+#include "Process.h"
+
+void RunQueue::push(const std::shared_ptr<Process>& process) {
+    std::lock_guard lock(queueMutex);
+    enqueue(process);
+    count.store(queued(), std::memory_order_release);
+}
+
+std::shared_ptr<Process> RunQueue::pop() {
+    // Lock-free early out for the (very common) empty queue
+    if (empty())
+        return nullptr;
+
+    std::lock_guard lock(queueMutex);
+    if (queued() == 0)
+        return nullptr;
+
+    auto process = dequeue();
+    count.store(queued(), std::memory_order_release);
+
+    return process;
+}
+
+std::shared_ptr<Process> RunQueue::steal() {
+    if (empty())
+        return nullptr;
+
+    // Don't fight the owner for the lock, just move on to the next victim
+    std::unique_lock lock(queueMutex, std::try_to_lock);
+    if (!lock.owns_lock() || queued() == 0)
+        return nullptr;
+
+    auto process = dequeueForSteal();
+    count.store(queued(), std::memory_order_release);
+
+    return process;
+}
+
+void RunQueue::updateAll(const std::function<void(Process&)>& update) {
+    std::lock_guard lock(queueMutex);
+    requeueAll(update);
+    count.store(queued(), std::memory_order_release);
+}
+
+std::optional<uint64_t> RunQueue::peekKey() {
+    if (empty())
+        return std::nullopt;
+
+    std::lock_guard lock(queueMutex);
+    return topKey();
+}
+
+size_t RunQueue::size() const {
+    return count.load(std::memory_order_acquire);
+}
+
+bool RunQueue::empty() const {
+    return size() == 0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+class Process;
+
+/// @class RunQueue
+/// @brief A per-core ready queue that other cores may steal from.
+///
+/// Handles the locking and leaves the ordering to the scheduling policy that
+/// derives from it. The size is mirrored in an atomic so that cores can skip
+/// empty queues without ever touching the lock, which is the common case for
+/// idle cores scanning for work.
+class alignas(64) RunQueue {
+public:
+    RunQueue() = default;
+    virtual ~RunQueue() = default;
+
+    RunQueue(const RunQueue&) = delete;
+    RunQueue& operator=(const RunQueue&) = delete;
+
+    void push(const std::shared_ptr<Process>& process);
+
+    /// @brief Pops the process that should run next. Used by the owning core.
+    std::shared_ptr<Process> pop();
+
+    /// @brief Takes a process for another core. Used by idle cores looking for work.
+    std::shared_ptr<Process> steal();
+
+    /// @brief Applies the update to every queued process and requeues them, e.g.
+    /// for a priority boost.
+    void updateAll(const std::function<void(Process&)>& update);
+
+    /// @brief Key of the process that would be popped next, for policies that
+    /// order by one. Lower runs first.
+    [[nodiscard]] std::optional<uint64_t> peekKey();
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+protected:
+    // Called with the lock held
+    virtual void enqueue(const std::shared_ptr<Process>& process) = 0;
+    virtual std::shared_ptr<Process> dequeue() = 0;
+    virtual std::shared_ptr<Process> dequeueForSteal() = 0;
+    virtual void requeueAll(const std::function<void(Process&)>& update) = 0;
+    [[nodiscard]] virtual std::optional<uint64_t> topKey() const {
+        return std::nullopt;
+    }
+    [[nodiscard]] virtual size_t queued() const = 0;
+
+private:
+    std::mutex queueMutex;
+    std::atomic<size_t> count = 0;
+};
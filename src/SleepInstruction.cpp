@@ -1,21 +1,12 @@
 #include "SleepInstruction.h"
 
-#include "ConsoleManager.h"
-#include "ProcessScheduler.h"
+#include <format>
 
 SleepInstruction::SleepInstruction(const uint8_t ticks, const int pid) : Instruction(1, pid), ticks(ticks) {
-    this->opCode = "SLEEP";
 }
 
-void SleepInstruction::execute() {
-    const auto process = getProcess();
-
-    const auto currentTicks = ProcessScheduler::getInstance().getTotalCPUTicks();
-    const uint64_t wakeupTick = ticks + currentTicks;
-    process->setWakeupTick(wakeupTick);
-    process->setStatus(WAITING);
-
-    ProcessScheduler::getInstance().sleepProcess(process);
+Bytecode SleepInstruction::encode(Program&) const {
+    return {Opcode::SLEEP, 0, ticks};
 }
 
 std::string SleepInstruction::serialize() const {
@@ -5,7 +5,7 @@ public:
     SleepInstruction(uint8_t ticks, const int pid);
 
 private:
-    uint8_t ticks;
-    void execute() override;
+    const uint8_t ticks;
+    Bytecode encode(Program& program) const override;
     std::string serialize() const override;
 };
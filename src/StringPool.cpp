@@ -0,0 +1,22 @@
+#include "StringPool.h"
+
+StringPool& StringPool::getInstance() {
+    static auto* instance = new StringPool();
+    return *instance;
+}
+
+const std::string* StringPool::acquire(const std::string_view text) {
+    std::lock_guard lock(mutex);
+    auto it = strings.find(text);
+    if (it == strings.end())
+        it = strings.emplace(text, 0).first;
+
+    ++it->second;
+    return &it->first;
+}
+
+void StringPool::release(const std::string* text) {
+    std::lock_guard lock(mutex);
+    if (const auto it = strings.find(std::string_view(*text)); it != strings.end() && --it->second == 0)
+        strings.erase(it);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// @class StringPool
+/// @brief Every distinct string any program uses, stored once.
+///
+/// Programs keep pointers into the pool instead of their own copies, so a
+/// message or variable name repeated across thousands of processes costs one
+/// allocation. Each string is counted by the programs holding it and removed
+/// once the last of them releases it, so a pointer stays valid until then.
+class StringPool {
+public:
+    static StringPool& getInstance();
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    /// @return The pooled copy of the string, added if it's new. Has to be
+    /// matched by a release.
+    const std::string* acquire(std::string_view text);
+    /// @brief Removes the string once nothing holds it anymore.
+    void release(const std::string* text);
+
+private:
+    StringPool() = default;
+
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(const std::string_view text) const {
+            return std::hash<std::string_view>{}(text);
+        }
+    };
+
+    std::unordered_map<std::string, size_t, Hash, std::equal_to<>> strings;  // With their holders
+    std::mutex mutex;
+};
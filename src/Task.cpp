@@ -0,0 +1,34 @@
+#include "Task.h"
+
+#include <utility>
+
+Task::Task(const std::coroutine_handle<promise_type> handle) : handle(handle) {
+}
+
+Task::~Task() {
+    if (handle)
+        handle.destroy();
+}
+
+Task::Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {
+}
+
+Task& Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        if (handle)
+            handle.destroy();
+        handle = std::exchange(other.handle, nullptr);
+    }
+
+    return *this;
+}
+
+void Task::resume() {
+    if (!handle || handle.done())
+        return;
+
+    handle.resume();
+
+    if (handle.promise().exception)
+        std::rethrow_exception(std::exchange(handle.promise().exception, nullptr));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+
+/// @class Task
+/// @brief A coroutine that is stepped by hand, one resume at a time.
+///
+/// Used for simulated cores: the coroutine runs until its next co_await
+/// (usually the end of a tick) and then hands control back to whoever resumed
+/// it, without any thread or lock involved. The coroutine starts suspended and
+/// stays suspended once it finishes, so it is only ever destroyed by its owning
+/// Task.
+class Task {
+public:
+    struct promise_type {
+        std::exception_ptr exception;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {
+        }
+        void unhandled_exception() {
+            exception = std::current_exception();
+        }
+    };
+
+    Task() = default;
+    ~Task();
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& other) noexcept;
+    Task& operator=(Task&& other) noexcept;
+
+    /// @brief Runs the coroutine up to its next suspension point.
+    /// Rethrows anything the coroutine threw.
+    void resume();
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle);
+
+    std::coroutine_handle<promise_type> handle;
+};
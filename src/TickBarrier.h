@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/// @brief Tells the CPU we're in a spin loop, so a sibling hyperthread gets the
+/// execution resources meanwhile.
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/// @class TickBarrier
+/// @brief Reusable barrier for the host threads, one phase per epoch.
+///
+/// Arrivals go up a combining tree with four participants to a node, each node
+/// on its own cache line, so no more than four threads ever fight over one
+/// counter. The last to reach the root runs the completion, which is called
+/// directly rather than through a std::function, and starts the next phase.
+///
+/// Waiting threads spin for a while before parking on the phase with
+/// std::atomic::wait, a futex on Linux. Each participant adapts how long it
+/// spins: longer after a phase that ended while it spun, shorter after one it
+/// had to park for. With more participants than host CPUs, the waiters yield
+/// instead of spinning in place, since the threads still to arrive may well
+/// need the CPU a spinner is holding.
+///
+/// Every participant has a fixed index below the count it was created with.
+template <typename Completion>
+class TickBarrier {
+public:
+    TickBarrier(const int participants, Completion completion)
+        : completion(std::move(completion)), slots(std::max(participants, 1)),
+          oversubscribed(static_cast<unsigned>(participants) > std::thread::hardware_concurrency()) {
+        std::vector<int> levelSizes;
+        for (int size = std::max(participants, 1); size > 1 || levelSizes.empty();) {
+            size = (size + FAN_IN - 1) / FAN_IN;
+            levelSizes.push_back(size);
+        }
+
+        // Leaves first, then each level up to the single root
+        int total = 0;
+        for (const int size : levelSizes) {
+            total += size;
+        }
+        nodes = std::vector<Node>(total);
+
+        int levelStart = 0;
+        int children = std::max(participants, 1);
+        for (size_t level = 0; level < levelSizes.size(); ++level) {
+            const int size = levelSizes[level];
+            for (int i = 0; i < size; ++i) {
+                Node& node = nodes[levelStart + i];
+                node.expected = std::min(FAN_IN, children - i * FAN_IN);
+                node.pending.store(node.expected, std::memory_order_relaxed);
+                if (level + 1 < levelSizes.size())
+                    node.parent = levelStart + size + i / FAN_IN;
+            }
+
+            levelStart += size;
+            children = size;
+        }
+    }
+
+    TickBarrier(const TickBarrier&) = delete;
+    TickBarrier& operator=(const TickBarrier&) = delete;
+
+    void arriveAndWait(const int participant) {
+        const uint32_t phase = this->phase.load(std::memory_order_acquire);
+        if (!arrive(participant, false))
+            wait(participant, phase);
+    }
+
+    /// @brief Arrives for this phase and leaves the barrier for good, without
+    /// waiting for the others.
+    void arriveAndDrop(const int participant) {
+        arrive(participant, true);
+    }
+
+private:
+    static constexpr int FAN_IN = 4;
+    static constexpr uint32_t MIN_SPINS = 64;
+    static constexpr uint32_t MAX_SPINS = 1 << 14;
+
+    struct alignas(64) Node {
+        std::atomic<int> pending = 0;  // Arrivals still missing this phase
+        std::atomic<int> dropped = 0;  // Children leaving for good this phase
+        int expected = 0;              // Only touched by whoever completes the node
+        int parent = -1;
+    };
+
+    struct alignas(64) Slot {
+        uint32_t spins = MIN_SPINS * 4;
+    };
+
+    // Returns true for the participant that completed the phase. A subtree
+    // whose children have all dropped out drops out of its parent in turn.
+    bool arrive(const int participant, bool dropping) {
+        int index = participant / FAN_IN;
+        for (;;) {
+            Node& node = nodes[index];
+            if (dropping)
+                node.dropped.fetch_add(1, std::memory_order_relaxed);
+            if (node.pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return false;
+
+            // Last one here, nobody else touches the node until the next phase
+            node.expected -= node.dropped.exchange(0, std::memory_order_relaxed);
+            node.pending.store(node.expected, std::memory_order_relaxed);
+            dropping = node.expected == 0;
+
+            if (node.parent == -1)
+                break;
+            index = node.parent;
+        }
+
+        completion();
+        phase.fetch_add(1, std::memory_order_release);
+        phase.notify_all();
+        return true;
+    }
+
+    void wait(const int participant, const uint32_t phase) {
+        uint32_t& spins = slots[participant].spins;
+        for (uint32_t spin = 0; spin < spins; ++spin) {
+            if (this->phase.load(std::memory_order_acquire) != phase) {
+                spins = std::min(spins * 2, MAX_SPINS);
+                return;
+            }
+
+            if (oversubscribed)
+                std::this_thread::yield();
+            else
+                cpuRelax();
+        }
+
+        spins = std::max(spins / 2, MIN_SPINS);
+        while (this->phase.load(std::memory_order_acquire) == phase) {
+            this->phase.wait(phase, std::memory_order_acquire);
+        }
+    }
+
+    Completion completion;
+    std::vector<Node> nodes;
+    std::vector<Slot> slots;  // Per participant, padded so spinning threads don't share lines
+    bool oversubscribed;
+    alignas(64) std::atomic<uint32_t> phase = 0;
+};
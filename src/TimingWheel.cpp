@@ -0,0 +1,145 @@
+#include "TimingWheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <utility>
+
+void TimingWheel::Level::add(const size_t slot, Entry entry) {
+    buckets[slot].push_back(std::move(entry));
+    occupied[slot / 64] |= uint64_t{1} << (slot % 64);
+}
+
+TimingWheel::Bucket TimingWheel::Level::take(const size_t slot) {
+    occupied[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    return std::exchange(buckets[slot], {});
+}
+
+// Finds the first occupied slot at or after the given one, wrapping around
+std::optional<size_t> TimingWheel::Level::findFrom(const size_t slot) const {
+    const size_t numWords = occupied.size();
+
+    for (size_t i = 0; i <= numWords; ++i) {
+        const size_t word = (slot / 64 + i) % numWords;
+        uint64_t bits = occupied[word];
+
+        if (i == 0)
+            bits &= ~uint64_t{0} << (slot % 64);  // Only the slots from the start onwards
+        else if (i == numWords)
+            bits &= (uint64_t{1} << (slot % 64)) - 1;  // Wrapped back, only the slots before the start
+
+        if (bits != 0)
+            return word * 64 + std::countr_zero(bits);
+    }
+
+    return std::nullopt;
+}
+
+void TimingWheel::insert(const std::shared_ptr<Process>& process, const uint64_t wakeupTick) {
+    // Anything already due goes into the very next bucket
+    place({std::max(wakeupTick, currentTick + 1), process});
+    ++count;
+}
+
+void TimingWheel::place(Entry entry) {
+    const uint64_t delta = entry.wakeupTick - currentTick;
+
+    if (delta < NUM_SLOTS) {
+        ticks.add(entry.wakeupTick & SLOT_MASK, std::move(entry));
+    } else if (delta < NUM_SLOTS * NUM_SLOTS) {
+        blocks.add((entry.wakeupTick >> SLOT_BITS) & SLOT_MASK, std::move(entry));
+    } else {
+        overflow.push_back(std::move(entry));
+    }
+}
+
+// Called right before expiring the first tick of a new block
+void TimingWheel::cascade(const uint64_t tick) {
+    // Pull in far-off sleepers once they're within reach of level 1
+    if (!overflow.empty()) {
+        for (auto& entry : std::exchange(overflow, {})) {
+            place(std::move(entry));
+        }
+    }
+
+    // Every entry in this block falls within the next NUM_SLOTS ticks
+    for (auto& entry : blocks.take((tick >> SLOT_BITS) & SLOT_MASK)) {
+        ticks.add(entry.wakeupTick & SLOT_MASK, std::move(entry));
+    }
+}
+
+void TimingWheel::advanceTo(const uint64_t tick, std::vector<std::shared_ptr<Process>>& out) {
+    // Nothing to expire, so there's nothing to cascade either
+    if (count == 0) {
+        currentTick = std::max(currentTick, tick);
+        return;
+    }
+
+    while (currentTick < tick) {
+        const uint64_t next = currentTick + 1;
+
+        if ((next & SLOT_MASK) == 0)
+            cascade(next);
+
+        currentTick = next;
+
+        for (auto& entry : ticks.take(next & SLOT_MASK)) {
+            out.push_back(std::move(entry.process));
+            --count;
+        }
+
+        if (count == 0) {
+            currentTick = tick;
+            break;
+        }
+    }
+}
+
+std::optional<uint64_t> TimingWheel::getNextWakeupTick() const {
+    if (count == 0)
+        return std::nullopt;
+
+    uint64_t nextTick = UINT64_MAX;
+
+    // Level 0 buckets map one-to-one onto the next NUM_SLOTS ticks
+    const uint64_t firstTick = currentTick + 1;
+    if (const auto slot = ticks.findFrom(firstTick & SLOT_MASK))
+        nextTick = firstTick + ((*slot - firstTick) & SLOT_MASK);
+
+    // Sleepers that went into level 1 or the overflow earlier can still be due
+    // before that, since those only get cascaded once per block
+    const uint64_t firstBlock = (currentTick >> SLOT_BITS) + 1;
+    if (const auto slot = blocks.findFrom(firstBlock & SLOT_MASK)) {
+        for (const auto& entry : blocks.buckets[*slot]) {
+            nextTick = std::min(nextTick, entry.wakeupTick);
+        }
+    }
+
+    for (const auto& entry : overflow) {
+        nextTick = std::min(nextTick, entry.wakeupTick);
+    }
+
+    return nextTick;
+}
+
+void TimingWheel::forEach(const std::function<void(const std::shared_ptr<Process>&)>& visit) const {
+    for (const auto* level : {&ticks, &blocks}) {
+        for (const auto& bucket : level->buckets) {
+            for (const auto& entry : bucket) {
+                visit(entry.process);
+            }
+        }
+    }
+
+    for (const auto& entry : overflow) {
+        visit(entry.process);
+    }
+}
+
+size_t TimingWheel::size() const {
+    return count;
+}
+
+bool TimingWheel::empty() const {
+    return count == 0;
+}
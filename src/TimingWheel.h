@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class Process;
+
+/// @class TimingWheel
+/// @brief Hierarchical timing wheel holding sleeping processes by wakeup tick.
+///
+/// Level 0 has one bucket per tick for the next 256 ticks, level 1 has one
+/// bucket per 256 ticks for the next 65536 ticks, and anything further out sits
+/// in an overflow list. Inserting is O(1), and advancing a tick hands back a
+/// whole bucket at once. Level 1 buckets are cascaded into level 0 whenever the
+/// wheel enters a new 256-tick block.
+///
+/// Not thread-safe; the scheduler guards it with its wait mutex.
+class TimingWheel {
+public:
+    void insert(const std::shared_ptr<Process>& process, uint64_t wakeupTick);
+
+    /// @brief Moves every process due at or before the given tick into out.
+    void advanceTo(uint64_t tick, std::vector<std::shared_ptr<Process>>& out);
+
+    /// @brief Earliest tick with a process due, if any.
+    [[nodiscard]] std::optional<uint64_t> getNextWakeupTick() const;
+
+    void forEach(const std::function<void(const std::shared_ptr<Process>&)>& visit) const;
+
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+private:
+    static constexpr int SLOT_BITS = 8;
+    static constexpr int NUM_SLOTS = 1 << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = NUM_SLOTS - 1;
+
+    struct Entry {
+        uint64_t wakeupTick;
+        std::shared_ptr<Process> process;
+    };
+    using Bucket = std::vector<Entry>;
+
+    // One bit per bucket so finding the next non-empty bucket is a few word scans
+    using Occupancy = std::array<uint64_t, NUM_SLOTS / 64>;
+
+    struct Level {
+        std::array<Bucket, NUM_SLOTS> buckets;
+        Occupancy occupied{};
+
+        void add(size_t slot, Entry entry);
+        Bucket take(size_t slot);
+        [[nodiscard]] std::optional<size_t> findFrom(size_t slot) const;
+    };
+
+    void place(Entry entry);
+    void cascade(uint64_t tick);
+
+    Level ticks;   // Level 0, one bucket per tick
+    Level blocks;  // Level 1, one bucket per NUM_SLOTS ticks
+    Bucket overflow;
+
+    uint64_t currentTick = 0;  // Every tick up to and including this has been expired
+    size_t count = 0;
+};
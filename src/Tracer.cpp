@@ -0,0 +1,241 @@
+#include "Tracer.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <fstream>
+
+using namespace std::chrono_literals;
+
+// File layout: this magic, the format version and the event size, then events
+static constexpr std::array<char, 8> TRACE_MAGIC = {'T', 'I', 'C', 'K', 'T', 'R', 'C', '1'};
+static constexpr uint32_t TRACE_VERSION = 1;
+
+thread_local int currentTraceCore = -1;
+
+Tracer& Tracer::getInstance() {
+    static auto* instance = new Tracer();
+    return *instance;
+}
+
+Tracer::~Tracer() {
+    stop();
+}
+
+Tracer::Ring::Ring(const size_t capacity) : events(std::bit_ceil(std::max<size_t>(capacity, 2))) {
+    mask = events.size() - 1;
+}
+
+bool Tracer::Ring::push(const TraceEvent& event) {
+    const size_t position = head.load(std::memory_order_relaxed);
+    if (position - tail.load(std::memory_order_acquire) == events.size())
+        return false;
+
+    events[position & mask] = event;
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+size_t Tracer::Ring::drainTo(std::FILE* out) {
+    const size_t first = tail.load(std::memory_order_relaxed);
+    const size_t last = head.load(std::memory_order_acquire);
+
+    // At most two runs, before and after the wraparound
+    for (size_t position = first; position != last;) {
+        const size_t run = std::min(last - position, events.size() - (position & mask));
+        std::fwrite(&events[position & mask], sizeof(TraceEvent), run, out);
+        position += run;
+    }
+
+    tail.store(last, std::memory_order_release);
+    return last - first;
+}
+
+void Tracer::initialize(const int numCores, const size_t eventsPerCore) {
+    stop();
+
+    rings.clear();
+    for (int core = 0; core <= numCores; ++core) {
+        rings.push_back(std::make_unique<Ring>(eventsPerCore));
+    }
+}
+
+bool Tracer::start(const std::string& path) {
+    std::lock_guard lock(controlMutex);
+    if (enabled)
+        return true;
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    const uint32_t eventSize = sizeof(TraceEvent);
+    std::fwrite(TRACE_MAGIC.data(), 1, TRACE_MAGIC.size(), file);
+    std::fwrite(&TRACE_VERSION, sizeof(TRACE_VERSION), 1, file);
+    std::fwrite(&eventSize, sizeof(eventSize), 1, file);
+
+    // Anything left over from an earlier trace doesn't belong in this one
+    for (const auto& ring : rings) {
+        ring->tail.store(ring->head.load());
+    }
+
+    dropped = 0;
+    enabled = true;
+    drainer = std::thread(&Tracer::drainerLoop, this);
+    return true;
+}
+
+void Tracer::stop() {
+    std::lock_guard lock(controlMutex);
+    if (!enabled)
+        return;
+
+    enabled = false;
+    if (drainer.joinable())
+        drainer.join();
+
+    // An event a core was recording right as tracing stopped may miss this, it
+    // gets thrown away when the next trace starts
+    drainAll();
+
+    std::fclose(file);
+    file = nullptr;
+}
+
+bool Tracer::isEnabled() const {
+    return enabled;
+}
+
+uint64_t Tracer::getDropped() const {
+    return dropped;
+}
+
+void Tracer::setCurrentCore(const int core) {
+    currentTraceCore = core;
+}
+
+int Tracer::currentCore() {
+    return currentTraceCore;
+}
+
+// Only the host thread running a core may push into that core's ring, anyone
+// else goes through the shared one
+void Tracer::push(const TraceEventType type, const uint64_t tick, const int pid, const uint64_t arg,
+                  const int core) {
+    const TraceEvent event{tick, arg, pid, static_cast<int16_t>(core), type};
+
+    const int producer = currentTraceCore;
+    bool recorded;
+    if (producer >= 0 && producer + 1 < static_cast<int>(rings.size())) {
+        recorded = rings[producer]->push(event);
+    } else {
+        std::lock_guard lock(sharedRingMutex);
+        recorded = rings.back()->push(event);
+    }
+
+    if (!recorded)
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Tracer::drainAll() {
+    for (const auto& ring : rings) {
+        ring->drainTo(file);
+    }
+    std::fflush(file);
+}
+
+void Tracer::drainerLoop() {
+    while (enabled) {
+        drainAll();
+        std::this_thread::sleep_for(10ms);
+    }
+}
+
+bool Tracer::exportChromeTrace(const std::string& tracePath, const std::string& jsonPath,
+                               const std::function<std::string(int)>& processName) {
+    std::ifstream in(tracePath, std::ios::binary);
+
+    std::array<char, 8> magic{};
+    uint32_t version = 0;
+    uint32_t eventSize = 0;
+    in.read(magic.data(), magic.size());
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&eventSize), sizeof(eventSize));
+    if (!in || magic != TRACE_MAGIC || version != TRACE_VERSION || eventSize != sizeof(TraceEvent))
+        return false;
+
+    std::vector<TraceEvent> events;
+    for (TraceEvent event{}; in.read(reinterpret_cast<char*>(&event), sizeof(event));) {
+        events.push_back(event);
+    }
+
+    // The rings are drained one after the other, but each is in order on its own
+    std::ranges::stable_sort(events, {}, &TraceEvent::tick);
+
+    std::ofstream out(jsonPath);
+    if (!out)
+        return false;
+
+    // Events from outside the cores go on a track after the last core
+    int16_t schedulerTrack = 0;
+    for (const auto& event : events) {
+        schedulerTrack = std::max<int16_t>(schedulerTrack, static_cast<int16_t>(event.core + 1));
+    }
+    const auto track = [&](const TraceEvent& event) { return event.core >= 0 ? event.core : schedulerTrack; };
+
+    out << R"({"displayTimeUnit": "ms", "traceEvents": [)" << '\n';
+    out << std::format(R"(  {{"name": "thread_name", "ph": "M", "pid": 0, "tid": {}, "args": {{"name": "Scheduler"}}}})",
+                       schedulerTrack);
+    for (int16_t core = 0; core < schedulerTrack; ++core) {
+        out << ",\n"
+            << std::format(R"(  {{"name": "thread_name", "ph": "M", "pid": 0, "tid": {}, "args": {{"name": "Core {}"}}}})",
+                           core, core);
+    }
+
+    // Ticks are shown as microseconds. A process's time on a core is a slice
+    // from its dispatch, or waking up on the core, to whatever took it off.
+    for (const auto& event : events) {
+        const std::string name = processName(event.pid);
+        const int tid = track(event);
+
+        std::string phase;
+        std::string label = name;
+        std::string args = std::format(R"("pid": {})", event.pid);
+        switch (event.type) {
+            case TraceEventType::DISPATCH:
+                phase = "B";
+                break;
+            case TraceEventType::WAKE:
+                phase = event.core >= 0 ? "B" : "i";
+                label = event.core >= 0 ? name : "wake " + name;
+                break;
+            case TraceEventType::PREEMPT:
+            case TraceEventType::FINISH:
+                phase = "E";
+                break;
+            case TraceEventType::SLEEP:
+                phase = "E";
+                args += std::format(R"(, "wakeup": {})", event.arg);
+                break;
+            case TraceEventType::PAGE_FAULT:
+                phase = "i";
+                label = "page fault";
+                args += std::format(R"(, "page": {})", event.arg);
+                break;
+            case TraceEventType::EVICT:
+                phase = "i";
+                label = "evict";
+                args += std::format(R"(, "page": {})", event.arg);
+                break;
+        }
+
+        out << ",\n"
+            << std::format(R"(  {{"name": "{}", "ph": "{}", "ts": {}, "pid": 0, "tid": {}{}, "args": {{{}}}}})", label,
+                           phase, event.tick, tid, phase == "i" ? R"(, "s": "t")" : "", args);
+    }
+    out << "\n]}\n";
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class TraceEventType : uint8_t {
+    DISPATCH,    // A core picked up the process
+    PREEMPT,     // The process was taken off its core while still runnable
+    SLEEP,       // The process went to sleep, arg is its wakeup tick
+    WAKE,        // The process woke up
+    PAGE_FAULT,  // arg is the page number
+    EVICT,       // A page of the process was evicted, arg is the page number
+    FINISH,      // The process ran its last instruction
+};
+
+// Fixed size so the trace file is just an array of these after the header
+struct TraceEvent {
+    uint64_t tick;
+    uint64_t arg;
+    int32_t pid;
+    int16_t core;  // -1 for events from outside the cores, e.g. wakeups
+    TraceEventType type;
+    uint8_t reserved = 0;
+};
+static_assert(sizeof(TraceEvent) == 24);
+
+/// @class Tracer
+/// @brief Opt-in recorder of scheduling events, written to a binary trace file.
+///
+/// Every simulated core has its own single-producer ring buffer, so recording
+/// an event is a couple of stores and never takes a lock or blocks the core.
+/// A background thread drains the rings into the file every few milliseconds.
+/// If a ring fills up before it's drained the event is dropped and counted.
+/// Events from outside the cores go into one more ring behind a mutex.
+///
+/// When tracing is off, recording is a single relaxed load.
+class Tracer {
+public:
+    static Tracer& getInstance();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /// @brief Sets up one ring per core. Called by the scheduler before any core runs.
+    void initialize(int numCores, size_t eventsPerCore);
+
+    /// @return False if the file couldn't be opened.
+    bool start(const std::string& path);
+    void stop();
+    [[nodiscard]] bool isEnabled() const;
+    [[nodiscard]] uint64_t getDropped() const;
+
+    /// @brief Core whose events the calling host thread is recording, -1 for none.
+    static void setCurrentCore(int core);
+
+    void record(const TraceEventType type, const uint64_t tick, const int pid, const uint64_t arg = 0) {
+        if (enabled.load(std::memory_order_relaxed))
+            push(type, tick, pid, arg, currentCore());
+    }
+
+    /// @brief Records an event for the given core from wherever the caller is,
+    /// e.g. a preemption decided in the barrier completion step.
+    void recordOn(const int core, const TraceEventType type, const uint64_t tick, const int pid,
+                  const uint64_t arg = 0) {
+        if (enabled.load(std::memory_order_relaxed))
+            push(type, tick, pid, arg, core);
+    }
+
+    /// @brief Converts a binary trace to Chrome trace event JSON, which
+    /// chrome://tracing and Perfetto can open. Each core is a thread, with a
+    /// slice for every stretch a process spent on it.
+    /// @return False if the trace couldn't be read or the JSON written.
+    static bool exportChromeTrace(const std::string& tracePath, const std::string& jsonPath,
+                                  const std::function<std::string(int)>& processName);
+
+private:
+    Tracer() = default;
+    ~Tracer();
+
+    // Single producer, single consumer. The indices only ever grow and are
+    // masked on access, each on its own cache line so the two sides don't contend.
+    struct Ring {
+        explicit Ring(size_t capacity);
+
+        bool push(const TraceEvent& event);
+        size_t drainTo(std::FILE* file);
+
+        std::vector<TraceEvent> events;
+        size_t mask;
+        alignas(64) std::atomic<size_t> head = 0;  // Written by the producer
+        alignas(64) std::atomic<size_t> tail = 0;  // Written by the drainer
+    };
+
+    [[nodiscard]] static int currentCore();
+    void push(TraceEventType type, uint64_t tick, int pid, uint64_t arg, int core);
+    void drainAll();
+    void drainerLoop();
+
+    std::vector<std::unique_ptr<Ring>> rings;  // One per core, then the shared one
+    std::mutex sharedRingMutex;
+
+    std::atomic<bool> enabled = false;
+    std::atomic<uint64_t> dropped = 0;
+    std::FILE* file = nullptr;
+    std::thread drainer;
+    std::mutex controlMutex;  // Serializes start and stop
+};
@@ -2,11 +2,8 @@
 
 #include <format>
 
-#include "Process.h"
-
 WriteInstruction::WriteInstruction(const int address, const uint16_t value, const int pid)
     : Instruction(1, pid), address(address), value(value) {
-    this->opCode = "WRITE";
     if (pid < 0) {
         throw std::runtime_error("BRUH");
     }
@@ -14,23 +11,32 @@ WriteInstruction::WriteInstruction(const int address, const uint16_t value, cons
 
 WriteInstruction::WriteInstruction(const int address, const std::string &varName, const int pid)
     : Instruction(1, pid), address(address), value(0), varName(varName), hasVar(true) {
-    this->opCode = "WRITE";
     if (pid < 0) {
         throw std::runtime_error("BRUH");
     }
 }
 
-void WriteInstruction::execute() {
-    const auto proc = getProcess();
-
+Bytecode WriteInstruction::encode(Program& program) const {
+    Bytecode bytecode{Opcode::WRITE};
     if (hasVar && !varName.empty()) {
-        value = proc->getVariable(varName);
+        bytecode.flags = A_IS_VAR;
+        bytecode.a = program.variable(varName, true);
+    } else {
+        bytecode.a = value;
     }
 
-    proc->writeToHeap(address, value);
+    bytecode.setAddress(address);
+    return bytecode;
 }
 
 std::string WriteInstruction::serialize() const {
     std::string valueStr = hasVar ? varName : std::to_string(value);
     return std::format("W {} {} {} {}", hasVar, address, valueStr, pid);
 }
+
+std::shared_ptr<WriteInstruction> WriteInstruction::relocated(const int offset) const {
+    if (hasVar)
+        return std::make_shared<WriteInstruction>(address + offset, varName, pid);
+
+    return std::make_shared<WriteInstruction>(address + offset, value, pid);
+}
@@ -5,12 +5,15 @@ class WriteInstruction final : public Instruction {
 public:
     WriteInstruction(int address, uint16_t value, int pid);
     WriteInstruction(int address, const std::string &varName, int pid);
-    void execute() override;
+    Bytecode encode(Program& program) const override;
     std::string serialize() const override;
 
+    /// @brief A copy writing to the address this many bytes further on.
+    std::shared_ptr<WriteInstruction> relocated(int offset) const;
+
 private:
-    int address;
-    uint16_t value;
-    std::string varName;
-    bool hasVar = false;
+    const int address;
+    const uint16_t value;
+    const std::string varName;
+    const bool hasVar = false;
 };